@@ -0,0 +1,95 @@
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "constants.hpp"
+
+using U64 = uint64_t;
+
+// ************************************
+// *    SLIDER LOOKUP MICRO-BENCHMARK
+// ************************************
+// before: relevant occupancy mask recalculated on every lookup
+// after:  MagicEntry (mask, magic, shift, attacks) precomputed per square
+// pext:   same entries indexed with BMI2 pext (if available)
+
+U64 legacy_rook_attacks(int square, Board &game_state){
+    U64 relevant_occupancy = rook_relevant_occupancy(square) & game_state.both_occupancy_bitboard;
+    int magic_index = relevant_occupancy * rook_magic_numbers[square] >> (64-rook_relevant_occupancy_count[square]);
+
+    return rook_magic_table[square].attacks[magic_index];
+}
+
+U64 legacy_bishop_attacks(int square, Board &game_state){
+    U64 relevant_occupancy = bishop_relevant_occupancy(square) & game_state.both_occupancy_bitboard;
+    int magic_index = relevant_occupancy * bishop_magic_numbers[square] >> (64-bishop_relevant_occupancy_count[square]);
+
+    return bishop_magic_table[square].attacks[magic_index];
+}
+
+template<typename LookupFunction>
+double measure(const char *name, LookupFunction lookup, std::vector<Board> &boards, int rounds){
+    U64 checksum = 0ULL;
+    long long lookups = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++){
+        for(Board &board : boards){
+            for(int square = 0; square < 64; square++){
+                checksum += lookup(square, board);
+            }
+            lookups += 64;
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    double lookups_per_second = lookups / seconds;
+
+    printf("%-22s %8.2f M lookups/s   (checksum: %llx)\n", name, lookups_per_second / 1e6, (unsigned long long)checksum);
+
+    return lookups_per_second;
+}
+
+int main(int argc, char const *argv[])
+{
+    init_all_lookup_tables();
+
+    // random occupancies (sparse, like real positions)
+    constexpr U64 SEED = 123456789ULL;
+    std::mt19937_64 gen(SEED);
+
+    std::vector<Board> boards(4096);
+    for(Board &b : boards){
+        b.both_occupancy_bitboard = gen() & gen();
+    }
+
+    int rounds = argc > 1 ? std::stoi(argv[1]) : 200;
+
+    // legacy lookup uses magic indexing
+    set_slider_backend(SliderBackend::magic);
+
+    double rook_before = measure("rook   (before)", legacy_rook_attacks, boards, rounds);
+    double rook_after = measure("rook   (magic entry)", static_cast<U64 (*)(int, Board &)>(rook_attacks), boards, rounds);
+    double bishop_before = measure("bishop (before)", legacy_bishop_attacks, boards, rounds);
+    double bishop_after = measure("bishop (magic entry)", static_cast<U64 (*)(int, Board &)>(bishop_attacks), boards, rounds);
+
+    printf("\nspeedup: rook x%.2f, bishop x%.2f\n", rook_after / rook_before, bishop_after / bishop_before);
+
+    if(set_slider_backend(SliderBackend::pext)){
+        printf("\n");
+        double rook_pext = measure("rook   (pext)", static_cast<U64 (*)(int, Board &)>(rook_attacks), boards, rounds);
+        double bishop_pext = measure("bishop (pext)", static_cast<U64 (*)(int, Board &)>(bishop_attacks), boards, rounds);
+
+        printf("\npext vs magic entry: rook x%.2f, bishop x%.2f\n", rook_pext / rook_after, bishop_pext / bishop_after);
+    }
+    else{
+        printf("\npext backend not available on this build / CPU\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <chrono>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "moves.hpp"
+#include "perft.hpp"
+#include "chess_bot.hpp"
+#include "bench_positions.hpp"
+
+// ************************************
+// *             BENCH
+// ************************************
+// fixed position set through perft, get_best_move and eval
+// prints nodes, time, nps and signature - signature changes when any result changes
+// (move generation, search or evaluation), nps catches speed regressions
+// usage: bench [perft depth] [search depth]
+
+constexpr int DEFAULT_PERFT_DEPTH = 4;
+constexpr int DEFAULT_SEARCH_DEPTH = 3;
+constexpr int EVAL_REPEATS = 100000;
+
+// FNV-1a over 64-bit values
+void update_signature(U64 &signature, U64 value){
+    for(int i = 0; i < 8; i++){
+        signature ^= (value >> (i * 8)) & 0xff;
+        signature *= 0x100000001b3ULL;
+    }
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char const *argv[])
+{
+    init_all_lookup_tables();
+
+    const int perft_depth = argc > 1 ? std::stoi(argv[1]) : DEFAULT_PERFT_DEPTH;
+    const int search_depth = argc > 2 ? std::stoi(argv[2]) : DEFAULT_SEARCH_DEPTH;
+
+    Board board;
+    U64 signature = 0xcbf29ce484222325ULL;
+
+    // perft
+    unsigned long long perft_nodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(const char *fen : bench_positions){
+        board.load_fen(fen);
+        unsigned long long nodes = perft_count(perft_depth, board);
+        perft_nodes += nodes;
+        update_signature(signature, nodes);
+    }
+    double perft_seconds = seconds_since(start);
+
+    // search
+    unsigned long long searched_nodes = 0;
+    start = std::chrono::steady_clock::now();
+    for(const char *fen : bench_positions){
+        board.load_fen(fen);
+        search_nodes = 0;
+        Move best_move = get_best_move(board, search_depth);
+        searched_nodes += search_nodes;
+        update_signature(signature, search_nodes);
+        update_signature(signature, best_move.encoded_value);
+    }
+    double search_seconds = seconds_since(start);
+
+    // eval
+    unsigned long long evals = 0;
+    long long eval_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for(const char *fen : bench_positions){
+        board.load_fen(fen);
+        long long position_sum = 0;
+        for(int i = 0; i < EVAL_REPEATS; i++)
+            position_sum += eval(board);
+        evals += EVAL_REPEATS;
+        eval_sum += position_sum / EVAL_REPEATS;
+        update_signature(signature, (U64)(position_sum / EVAL_REPEATS));
+    }
+    double eval_seconds = seconds_since(start);
+
+    const int positions = sizeof(bench_positions) / sizeof(bench_positions[0]);
+    printf("positions:      %d\n", positions);
+    printf("perft  depth %d: %12llu nodes %8.3f s %12.0f nps\n", perft_depth, perft_nodes, perft_seconds, perft_nodes / perft_seconds);
+    printf("search depth %d: %12llu nodes %8.3f s %12.0f nps\n", search_depth, searched_nodes, search_seconds, searched_nodes / search_seconds);
+    printf("eval:           %12llu evals %8.3f s %12.1f ns/eval (sum %lld)\n", evals, eval_seconds, eval_seconds * 1e9 / evals, eval_sum);
+    printf("total nodes:    %llu\n", perft_nodes + searched_nodes);
+    printf("total time:     %.3f s\n", perft_seconds + search_seconds + eval_seconds);
+    printf("signature:      %016llx\n", (unsigned long long)signature);
+
+    return 0;
+}
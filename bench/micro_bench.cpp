@@ -0,0 +1,250 @@
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "moves.hpp"
+#include "chess_bot.hpp"
+
+// ************************************
+// *       PRIMITIVES MICRO-BENCHMARK
+// ************************************
+// every hot primitive measured in isolation over seeded random corpus of positions
+// (random legal games from start position - same seed, same corpus)
+// iterations are doubled until run takes at least min time, result in ns/op
+// usage: micro_bench [--seed n] [--positions n] [--min-time s] [--filter substring] [--json file]
+
+struct MicroBenchResult{
+    std::string name;
+    unsigned long long iterations;
+    double ns_per_op;
+    U64 checksum;
+};
+
+struct MicroBenchOptions{
+    U64 seed = 1;
+    int positions = 1024;
+    double min_time = 0.25;
+    std::string filter;
+    std::string json_path;
+};
+
+// positions from random legal games, restarted on game end or after max plies
+std::vector<Board> generate_corpus(int positions, U64 seed){
+    constexpr int MAX_GAME_PLIES = 120;
+
+    std::mt19937_64 rng(seed);
+    std::vector<Board> corpus;
+    corpus.reserve(positions);
+
+    Board board;
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    int plies = 0;
+
+    while((int)corpus.size() < positions){
+        MoveList moves;
+        generate_legal_moves(board, moves);
+
+        if(moves.size() == 0 || plies == MAX_GAME_PLIES){
+            board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+            plies = 0;
+            continue;
+        }
+
+        make_move(moves[rng() % moves.size()], board);
+        plies++;
+        corpus.push_back(board);
+    }
+
+    return corpus;
+}
+
+// op(index) is one operation on corpus element index % corpus size
+template<typename Operation>
+void run_benchmark(const char *name, size_t corpus_size, Operation op,
+                   const MicroBenchOptions &options, std::vector<MicroBenchResult> &results){
+    if(!options.filter.empty() && std::string(name).find(options.filter) == std::string::npos)
+        return;
+
+    unsigned long long iterations = corpus_size;
+    while(true){
+        U64 checksum = 0ULL;
+
+        auto start = std::chrono::steady_clock::now();
+        for(unsigned long long i = 0; i < iterations; i++)
+            checksum += op(i % corpus_size);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if(seconds >= options.min_time){
+            results.push_back({name, iterations, seconds * 1e9 / iterations, checksum});
+            printf("%-24s %12llu iterations %10.2f ns/op   (checksum: %016llx)\n",
+                   name, iterations, seconds * 1e9 / iterations, (unsigned long long)checksum);
+            return;
+        }
+
+        iterations *= 2;
+    }
+}
+
+// google benchmark like layout (context + benchmarks array)
+void write_json(const std::string &path, const MicroBenchOptions &options, const std::vector<MicroBenchResult> &results){
+    std::ofstream file(path);
+
+    file << "{\n";
+    file << "  \"context\": {\n";
+    file << "    \"executable\": \"micro_bench\",\n";
+    file << "    \"seed\": " << options.seed << ",\n";
+    file << "    \"corpus_positions\": " << options.positions << ",\n";
+    file << "    \"slider_backend\": \"" << slider_backend_name(slider_backend) << "\"\n";
+    file << "  },\n";
+    file << "  \"benchmarks\": [\n";
+    for(size_t i = 0; i < results.size(); i++){
+        const MicroBenchResult &result = results[i];
+        file << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+             << ", \"real_time\": " << result.ns_per_op << ", \"time_unit\": \"ns\", \"checksum\": \""
+             << std::hex << result.checksum << std::dec << "\"}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+}
+
+int main(int argc, char const *argv[])
+{
+    MicroBenchOptions options;
+
+    for(int i = 1; i + 1 < argc; i += 2){
+        std::string argument = argv[i];
+
+        if(argument == "--seed")
+            options.seed = std::stoull(argv[i + 1]);
+        else if(argument == "--positions")
+            options.positions = std::stoi(argv[i + 1]);
+        else if(argument == "--min-time")
+            options.min_time = std::stod(argv[i + 1]);
+        else if(argument == "--filter")
+            options.filter = argv[i + 1];
+        else if(argument == "--json")
+            options.json_path = argv[i + 1];
+    }
+
+    init_all_lookup_tables();
+
+    std::vector<Board> corpus = generate_corpus(options.positions, options.seed);
+    std::vector<std::string> fens;
+    for(const Board &board : corpus)
+        fens.push_back(board.get_fen());
+
+    // random squares (one per corpus position)
+    std::mt19937_64 rng(options.seed);
+    std::vector<int> squares;
+    for(size_t i = 0; i < corpus.size(); i++)
+        squares.push_back(rng() % 64);
+
+    const size_t size = corpus.size();
+    std::vector<MicroBenchResult> results;
+    Board scratch;
+    MoveList moves;
+
+    printf("corpus: %zu positions (seed %llu), slider backend %s\n\n",
+           size, (unsigned long long)options.seed, slider_backend_name(slider_backend));
+
+    run_benchmark("rook_attacks", size, [&](size_t i){
+        return rook_attacks(squares[i], corpus[i].both_occupancy_bitboard);
+    }, options, results);
+
+    run_benchmark("bishop_attacks", size, [&](size_t i){
+        return bishop_attacks(squares[i], corpus[i].both_occupancy_bitboard);
+    }, options, results);
+
+    run_benchmark("queen_attacks", size, [&](size_t i){
+        return queen_attacks(squares[i], corpus[i]);
+    }, options, results);
+
+    run_benchmark("is_square_attacked_by", size, [&](size_t i){
+        return (U64)is_square_attacked_by(squares[i], !corpus[i].color_to_move, corpus[i]);
+    }, options, results);
+
+    run_benchmark("generate_moves", size, [&](size_t i){
+        moves.clear();
+        generate_moves(corpus[i], moves);
+        return (U64)moves.size();
+    }, options, results);
+
+    run_benchmark("generate_legal_moves", size, [&](size_t i){
+        moves.clear();
+        generate_legal_moves(corpus[i], moves);
+        return (U64)moves.size();
+    }, options, results);
+
+    // every legal move of position made and taken back, per move
+    std::vector<std::pair<int, Move>> corpus_moves;
+    for(size_t i = 0; i < size; i++){
+        moves.clear();
+        generate_legal_moves(corpus[i], moves);
+        for(const Move &move : moves)
+            corpus_moves.push_back({(int)i, move});
+    }
+
+    run_benchmark("make_move+unmake_move", corpus_moves.size(), [&](size_t i){
+        Board &board = corpus[corpus_moves[i].first];
+        Undo undo;
+        make_move(corpus_moves[i].second, board, undo);
+        U64 key = board.hash_key;
+        unmake_move(corpus_moves[i].second, undo, board);
+        return key;
+    }, options, results);
+
+    // in-check detection at search nodes: full mate test vs attack test vs parent's move check test
+    run_benchmark("isCheckMate", size, [&](size_t i){
+        return (U64)isCheckMate(corpus[i]);
+    }, options, results);
+
+    run_benchmark("isKingUnderAttack", size, [&](size_t i){
+        return (U64)isKingUnderAttack(corpus[i]);
+    }, options, results);
+
+    run_benchmark("compute_check_info", size, [&](size_t i){
+        CheckInfo check_info;
+        compute_check_info(corpus[i], check_info);
+        return check_info.discovered_check_candidates;
+    }, options, results);
+
+    std::vector<CheckInfo> check_infos(size);
+    for(size_t i = 0; i < size; i++)
+        compute_check_info(corpus[i], check_infos[i]);
+
+    run_benchmark("gives_check", corpus_moves.size(), [&](size_t i){
+        const int position = corpus_moves[i].first;
+        return (U64)gives_check(corpus_moves[i].second, corpus[position], check_infos[position]);
+    }, options, results);
+
+    run_benchmark("Board::load_fen", size, [&](size_t i){
+        scratch.load_fen(fens[i]);
+        return scratch.hash_key;
+    }, options, results);
+
+    run_benchmark("Board::operator=", size, [&](size_t i){
+        scratch = corpus[i];
+        return scratch.both_occupancy_bitboard;
+    }, options, results);
+
+    run_benchmark("eval", size, [&](size_t i){
+        return (U64)eval(corpus[i]);
+    }, options, results);
+
+    run_benchmark("eval_from_scratch", size, [&](size_t i){
+        return (U64)eval_from_scratch(corpus[i]);
+    }, options, results);
+
+    if(!options.json_path.empty()){
+        write_json(options.json_path, options, results);
+        printf("\nresults written to %s\n", options.json_path.c_str());
+    }
+
+    return 0;
+}
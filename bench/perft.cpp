@@ -0,0 +1,350 @@
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <charconv>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "moves.hpp"
+#include "perft.hpp"
+
+// ************************************
+// *             PERFT CLI
+// ************************************
+// usage:
+//   perft [options] <depth> [fen]          divide (nodes per root move), total nodes, nps
+//   perft [options] --epd <file> [depth]   suite of positions with expected counts (";D<depth> <nodes>"),
+//                                          depths above given depth are skipped
+// options:
+//   --threads <n>    parallel perft (root moves split between threads)
+//   --hash <mb>      perft hash table
+//   --detailed       detailed perft (captures, checks, mates, ...) instead of bulk counting
+// exit code 1 on first mismatch: root divide is printed, then failing subtree is narrowed down
+// against reference count (pseudo-legal moves filtered by legality check - no legal generator,
+// no hash, one thread) to first node whose move list or child count differs
+
+const char *START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct PerftOptions{
+    int threads = 1;
+    PerftTable *table = nullptr;
+    PerftMode mode = PerftMode::count_only;
+};
+
+struct EpdPosition{
+    std::string fen;
+    // (depth, expected nodes)
+    std::vector<std::pair<int, unsigned long long>> expected;
+};
+
+unsigned long long count_nodes(int depth, Board &board, const PerftOptions &options){
+    return parallel_perf(depth, board, options.threads, 1, options.table, options.mode).count;
+}
+
+// nodes below every root move; details (options.mode detailed) summed from root move subtrees
+PerftMovesCount divide(int depth, Board &board, const PerftOptions &options){
+    // perft(0) - position itself, no root moves
+    PerftMovesCount total;
+    if(depth <= 0){
+        total.count = 1;
+        printf("\nmoves: 0\nnodes: 1\n");
+        return total;
+    }
+
+    MoveList moves;
+    generate_legal_moves(board, moves);
+
+    for(const Move &move : moves){
+        Undo undo;
+        make_move(move, board, undo);
+        PerftMovesCount nodes;
+        if(depth > 1)
+            nodes = parallel_perf(depth - 1, board, options.threads, 1, options.table, options.mode);
+        else
+            nodes.count = 1;
+        unmake_move(move, undo, board);
+
+        printf("%s: %llu\n", move.to_uci().c_str(), nodes.count);
+        total += nodes;
+    }
+
+    printf("\nmoves: %d\nnodes: %llu\n", moves.size(), total.count);
+
+    // depth 1: details describe root moves themselves
+    if(depth == 1 && options.mode == PerftMode::detailed)
+        total = perf(1, board);
+
+    return total;
+}
+
+// reference: pseudo-legal moves filtered with isMoveLegal (independent of legal generator, hash and threads)
+unsigned long long reference_count(int depth, Board &board){
+    if(depth == 0)
+        return 1;
+
+    MoveList moves;
+    generate_moves(board, moves);
+
+    unsigned long long nodes = 0;
+    for(const Move &move : moves){
+        if(!isMoveLegal(move, board))
+            continue;
+
+        Undo undo;
+        make_move(move, board, undo);
+        nodes += reference_count(depth - 1, board);
+        unmake_move(move, undo, board);
+    }
+
+    return nodes;
+}
+
+bool contains_move(const MoveList &moves, const Move &move){
+    return std::any_of(moves.begin(), moves.end(), [&](const Move &other){ return other.encoded_value == move.encoded_value; });
+}
+
+// descends into first child whose count differs from reference, prints path to node where
+// legal move list itself differs (or where every child agrees - mismatch is in hash / threads)
+void narrow_mismatch(int depth, Board &board, const PerftOptions &options){
+    if(depth <= 0){
+        printf("\ndepth 0 - nothing to narrow down (perft(0) = 1, expected count is wrong)\n");
+        return;
+    }
+
+    std::vector<Move> path;
+    printf("\nreference: %llu nodes\n", reference_count(depth, board));
+
+    while(depth > 0){
+        MoveList moves;
+        generate_legal_moves(board, moves);
+
+        MoveList reference_moves;
+        generate_moves(board, reference_moves);
+        int reference_legal = 0;
+        for(const Move &move : reference_moves)
+            reference_legal += isMoveLegal(move, board);
+
+        printf("\npath:");
+        for(const Move &move : path)
+            printf(" %s", move.to_uci().c_str());
+        printf("%s\n%s (depth %d)\n", path.empty() ? " (root)" : "", board.get_fen().c_str(), depth);
+
+        if(moves.size() != reference_legal){
+            printf("legal moves: %d, reference: %d\n", moves.size(), reference_legal);
+            for(const Move &move : reference_moves)
+                if(isMoveLegal(move, board) && !contains_move(moves, move))
+                    printf("  missing: %s\n", move.to_uci().c_str());
+            for(const Move &move : moves)
+                if(!contains_move(reference_moves, move))
+                    printf("  extra:   %s\n", move.to_uci().c_str());
+            break;
+        }
+
+        bool found = false;
+        for(const Move &move : moves){
+            push_move(move, board);
+            unsigned long long nodes = depth > 1 ? count_nodes(depth - 1, board, options) : 1;
+            unsigned long long expected = reference_count(depth - 1, board);
+
+            if(nodes != expected){
+                printf("%s: %llu, reference %llu\n", move.to_uci().c_str(), nodes, expected);
+                path.push_back(move);
+                found = true;
+                break;
+            }
+            pop_move(board);
+        }
+
+        if(!found){
+            printf("every child matches reference - mismatch is not below this node (hash table / threads at node, or expected count)\n");
+            break;
+        }
+        depth--;
+    }
+
+    for(size_t i = 0; i < path.size(); i++)
+        pop_move(board);
+}
+
+// "<fen> ;D1 20 ;D2 400 ..." (fen may lack halfmove / fullmove fields)
+bool parse_epd_line(const std::string &line, EpdPosition &position){
+    std::stringstream fields(line);
+    std::string field;
+
+    if(!std::getline(fields, field, ';'))
+        return false;
+
+    std::stringstream fen_stream(field);
+    std::vector<std::string> fen_fields;
+    std::string fen_field;
+    while(fen_stream >> fen_field)
+        fen_fields.push_back(fen_field);
+
+    if(fen_fields.size() < 4)
+        return false;
+    if(fen_fields.size() == 4){
+        fen_fields.push_back("0");
+        fen_fields.push_back("1");
+    }
+
+    position.fen.clear();
+    for(const std::string &f : fen_fields)
+        position.fen += (position.fen.empty() ? "" : " ") + f;
+
+    position.expected.clear();
+    while(std::getline(fields, field, ';')){
+        std::stringstream depth_stream(field);
+        std::string depth_str;
+        unsigned long long nodes;
+        if(depth_stream >> depth_str >> nodes && depth_str.size() > 1 && depth_str[0] == 'D')
+            position.expected.push_back({std::stoi(depth_str.substr(1)), nodes});
+    }
+
+    return true;
+}
+
+int run_epd(const std::string &path, int max_depth, const PerftOptions &options){
+    std::ifstream file(path);
+    if(!file){
+        printf("Error: can't open %s\n", path.c_str());
+        return 2;
+    }
+
+    Board board;
+    unsigned long long total_nodes = 0;
+    double total_seconds = 0.0;
+    int line_number = 0;
+    int positions = 0;
+
+    std::string line;
+    while(std::getline(file, line)){
+        line_number++;
+
+        EpdPosition position;
+        if(!parse_epd_line(line, position))
+            continue;
+
+        positions++;
+        board.load_fen(position.fen);
+        printf("%3d: %s\n", line_number, position.fen.c_str());
+
+        for(const auto &[depth, expected] : position.expected){
+            if(depth > max_depth)
+                continue;
+
+            auto start = std::chrono::steady_clock::now();
+            unsigned long long nodes = count_nodes(depth, board, options);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            total_nodes += nodes;
+            total_seconds += seconds;
+
+            printf("     depth %d: %12llu nodes %9.3f s %11.0f nps %s\n",
+                   depth, nodes, seconds, nodes / seconds, nodes == expected ? "ok" : "MISMATCH");
+
+            if(nodes != expected){
+                printf("\nexpected %llu nodes, divide:\n", expected);
+                divide(depth, board, options);
+                narrow_mismatch(depth, board, options);
+                return 1;
+            }
+        }
+    }
+
+    printf("\n%d positions, %llu nodes %.3f s %.0f nps\n", positions, total_nodes, total_seconds, total_nodes / total_seconds);
+
+    return 0;
+}
+
+// whole argument must be non-negative integer
+bool parse_count(const std::string &text, int &value){
+    const char *end = text.data() + text.size();
+    auto [pointer, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc() && pointer == end && value >= 0;
+}
+
+int print_usage(){
+    printf("usage: perft [--threads n] [--hash mb] [--detailed] <depth> [fen]\n"
+           "       perft [--threads n] [--hash mb] [--detailed] --epd <file> [max depth]\n");
+    return 2;
+}
+
+int main(int argc, char const *argv[])
+{
+    init_all_lookup_tables();
+
+    PerftOptions options;
+    std::vector<std::string> arguments;
+    std::string epd_path;
+    int hash_mb = 0;
+
+    for(int i = 1; i < argc; i++){
+        std::string argument = argv[i];
+
+        if(argument == "--threads"){
+            if(i + 1 >= argc || !parse_count(argv[++i], options.threads) || options.threads < 1)
+                return print_usage();
+        }
+        else if(argument == "--hash"){
+            if(i + 1 >= argc || !parse_count(argv[++i], hash_mb))
+                return print_usage();
+        }
+        else if(argument == "--detailed")
+            options.mode = PerftMode::detailed;
+        else if(argument == "--epd"){
+            if(i + 1 >= argc)
+                return print_usage();
+            epd_path = argv[++i];
+        }
+        // unknown option (--help included)
+        else if(argument.starts_with("--"))
+            return print_usage();
+        else
+            arguments.push_back(argument);
+    }
+
+    // depth (or max depth for suite) comes first
+    int depth = 64;
+    if(arguments.empty() ? epd_path.empty() : !parse_count(arguments[0], depth))
+        return print_usage();
+
+    if(hash_mb > 0)
+        options.table = new PerftTable(hash_mb);
+
+    int result = 0;
+
+    if(!epd_path.empty()){
+        result = run_epd(epd_path, depth, options);
+    }
+    else{
+
+        // fen given as one or many arguments
+        std::string fen;
+        for(size_t i = 1; i < arguments.size(); i++)
+            fen += (fen.empty() ? "" : " ") + arguments[i];
+
+        Board board;
+        board.load_fen(fen.empty() ? START_FEN : fen);
+
+        auto start = std::chrono::steady_clock::now();
+        PerftMovesCount nodes = divide(depth, board, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("time: %.3f s\nnps: %.0f\n", seconds, nodes.count / seconds);
+
+        if(options.mode == PerftMode::detailed){
+            printf("details: ");
+            printPerftObject(nodes);
+        }
+    }
+
+    delete options.table;
+
+    return result;
+}
@@ -0,0 +1,354 @@
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "perft.hpp"
+
+// ************************************
+// *        PERFT SPEED BENCHMARK
+// ************************************
+// fixed positions and depths, prints nodes per second
+// (bulk counting perft_count - raw generator throughput, detailed perf() next to it)
+// used to compare engine builds (e.g. slider attack table layouts)
+// every available slider backend is run and node counts must match
+// perft must not allocate (counting allocator below)
+// copy-make vs make/unmake tree walk is compared on the same positions
+// parallel perft scaling: 1/2/4/.../N threads, totals must equal serial perf()
+// generator modes (captures / quiets) and is_pseudo_legal checked against full generator
+
+// counting allocator - every heap allocation in the program goes through it
+// (atomic - parallel perft allocates from several threads)
+std::atomic<unsigned long long> allocations_count = 0;
+
+void *operator new(std::size_t size){
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    if(void *pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+
+struct PerftBenchPosition{
+    const char *name;
+    const char *fen;
+    int depth;
+    // reference node count
+    unsigned long long expected;
+};
+
+const PerftBenchPosition perft_bench_positions[] = {
+    {"start",     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL},
+    {"kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL},
+};
+
+// legal generator validation: pins, en passant discovered checks, castling through attack,
+// promotions out of check (perft() vs copy-make reference vs known counts)
+const PerftBenchPosition perft_validation_positions[] = {
+    {"position6",         "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890ULL},
+    {"illegal ep 1",      "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL},
+    {"illegal ep 2",      "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133ULL},
+    {"ep gives check",    "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL},
+    {"castle check 1",    "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL},
+    {"castle check 2",    "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711ULL},
+    {"castle rights",     "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206ULL},
+    {"castle prevented",  "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476ULL},
+    {"promote out check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001ULL},
+    {"discovered check",  "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5, 1004658ULL},
+    {"promote check",     "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342ULL},
+    {"underpromote",      "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683ULL},
+    {"self stalemate",    "K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6, 2217ULL},
+    {"stalemate checkmate","8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL},
+    {"double check",      "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL},
+};
+
+// copy-make reference: pseudo-legal moves filtered with isMoveLegal
+unsigned long long reference_perft(int depth, Board &board){
+    if(depth == 0)
+        return 1;
+
+    MoveList moves;
+    generate_moves(board, moves);
+
+    unsigned long long nodes = 0;
+    for(const Move &move : moves){
+        if(!isMoveLegal(move, board))
+            continue;
+
+        Board copy = board;
+        make_move(move, copy);
+        nodes += reference_perft(depth - 1, copy);
+    }
+
+    return nodes;
+}
+
+// walks tree, at every node checks generator modes and is_pseudo_legal:
+// captures mode = captures + queen promotions filtered from full list, captures + quiets = full list,
+// every generated move is pseudo-legal, moves of same side two plies up missing from this node's list are not
+// returns number of nodes with a mismatch, captures counts generated captures
+unsigned long long generator_mode_mismatches(int depth, Board &board, const MoveList &grandparent_moves,
+                                             const MoveList &parent_moves, unsigned long long &captures){
+    MoveList moves, capture_moves, quiet_moves, expected;
+    generate_moves(board, moves);
+    generate_moves(board, capture_moves, GenType::captures);
+    generate_moves(board, quiet_moves, GenType::quiets);
+
+    for(const Move &move : moves){
+        int move_type = move.get_move_type();
+        if((move_type & static_cast<int>(MoveType::capture)) || move_type == static_cast<int>(MoveType::queen_promotion))
+            expected.push_back(move);
+    }
+
+    auto same_move = [](const Move &a, const Move &b){ return a.encoded_value == b.encoded_value; };
+    auto contains = [&](const MoveList &list, const Move &move){
+        return std::any_of(list.begin(), list.end(), [&](const Move &m){ return same_move(m, move); });
+    };
+
+    bool ok = std::equal(expected.begin(), expected.end(), capture_moves.begin(), capture_moves.end(), same_move);
+    ok &= capture_moves.size() + quiet_moves.size() == moves.size();
+    for(const Move &move : quiet_moves)
+        ok &= contains(moves, move) && !contains(capture_moves, move);
+    for(const Move &move : moves)
+        ok &= is_pseudo_legal(move, board);
+    for(const Move &move : grandparent_moves)
+        ok &= is_pseudo_legal(move, board) == contains(moves, move);
+
+    captures += capture_moves.size();
+    unsigned long long mismatches = !ok;
+
+    if(depth > 1){
+        for(const Move &move : moves){
+            if(!isMoveLegal(move, board))
+                continue;
+
+            Undo undo;
+            make_move(move, board, undo);
+            mismatches += generator_mode_mismatches(depth - 1, board, parent_moves, moves, captures);
+            unmake_move(move, undo, board);
+        }
+    }
+
+    return mismatches;
+}
+
+// count-only perft, Board copied at every node
+unsigned long long copy_make_perft(int depth, Board &board){
+    MoveList moves;
+    generate_legal_moves(board, moves);
+
+    if(depth == 1)
+        return moves.size();
+
+    unsigned long long nodes = 0;
+    for(const Move &move : moves){
+        Board copy = board;
+        make_move(move, copy);
+        nodes += copy_make_perft(depth - 1, copy);
+    }
+
+    return nodes;
+}
+
+// count-only perft, single Board walked in place
+unsigned long long make_unmake_perft(int depth, Board &board){
+    MoveList moves;
+    generate_legal_moves(board, moves);
+
+    if(depth == 1)
+        return moves.size();
+
+    unsigned long long nodes = 0;
+    for(const Move &move : moves){
+        Undo undo;
+        make_move(move, board, undo);
+        nodes += make_unmake_perft(depth - 1, board);
+        unmake_move(move, undo, board);
+    }
+
+    return nodes;
+}
+
+// unmake must restore every field of the position
+bool same_position(const Board &a, const Board &b){
+    for(int i = 0; i < 12; i++)
+        if(a.bitboards[i] != b.bitboards[i])
+            return false;
+
+    return a.color_occupancy_bitboards[0] == b.color_occupancy_bitboards[0] &&
+           a.color_occupancy_bitboards[1] == b.color_occupancy_bitboards[1] &&
+           a.both_occupancy_bitboard == b.both_occupancy_bitboard && a.mailbox == b.mailbox &&
+           a.color_to_move == b.color_to_move && a.castles == b.castles &&
+           a.en_passant_square == b.en_passant_square &&
+           a.halfmove_counter == b.halfmove_counter && a.fullmove_number == b.fullmove_number &&
+           a.hash_key == b.hash_key && a.pawn_key == b.pawn_key && a.material_key == b.material_key;
+}
+
+int main()
+{
+    Board board;
+    init_all_lookup_tables();
+
+    printf("slider attack tables: rook %zu KB, bishop %zu KB\n\n",
+           sizeof(rook_attack_table) / 1024, sizeof(bishop_attack_table) / 1024);
+
+    bool mismatch = false;
+
+    for(SliderBackend backend : {SliderBackend::magic, SliderBackend::pext}){
+        if(!set_slider_backend(backend)){
+            printf("backend %s: not available\n\n", slider_backend_name(backend));
+            continue;
+        }
+
+        printf("backend %s:\n", slider_backend_name(backend));
+
+        unsigned long long total_nodes = 0;
+        double total_seconds = 0.0;
+
+        for(const PerftBenchPosition &position : perft_bench_positions){
+            board.load_fen(position.fen);
+
+            unsigned long long allocations_before = allocations_count;
+            auto start = std::chrono::steady_clock::now();
+            unsigned long long nodes = perft_count(position.depth, board);
+            auto middle = std::chrono::steady_clock::now();
+            PerftMovesCount detailed = perf(position.depth, board);
+            auto stop = std::chrono::steady_clock::now();
+            unsigned long long allocations = allocations_count - allocations_before;
+
+            double seconds = std::chrono::duration<double>(middle - start).count();
+            double detailed_seconds = std::chrono::duration<double>(stop - middle).count();
+            total_nodes += nodes;
+            total_seconds += seconds;
+
+            printf("%-10s depth %d: %12llu nodes %9.3f s %10.0f nps (detailed %10.0f nps) %6llu allocations\n",
+                   position.name, position.depth, nodes, seconds, nodes / seconds, detailed.count / detailed_seconds, allocations);
+
+            if(nodes != position.expected || detailed.count != position.expected){
+                printf("MISMATCH: %s expected %llu nodes\n", position.name, position.expected);
+                mismatch = true;
+            }
+
+            if(allocations != 0){
+                printf("ALLOCATIONS: %s perft allocated %llu times (%.3f per node)\n",
+                       position.name, allocations, (double)allocations / nodes);
+                mismatch = true;
+            }
+        }
+
+        printf("total: %llu nodes %.3f s %.0f nps\n\n", total_nodes, total_seconds, total_nodes / total_seconds);
+    }
+
+    // copy-make vs make/unmake
+    init_all_lookup_tables();
+    printf("copy-make vs make/unmake (sizeof(Board) = %zu bytes):\n", sizeof(Board));
+
+    for(const PerftBenchPosition &position : perft_bench_positions){
+        board.load_fen(position.fen);
+        Board initial = board;
+
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long copy_nodes = copy_make_perft(position.depth, board);
+        auto middle = std::chrono::steady_clock::now();
+        unsigned long long unmake_nodes = make_unmake_perft(position.depth, board);
+        auto stop = std::chrono::steady_clock::now();
+
+        double copy_seconds = std::chrono::duration<double>(middle - start).count();
+        double unmake_seconds = std::chrono::duration<double>(stop - middle).count();
+        bool ok = copy_nodes == position.expected && unmake_nodes == position.expected && same_position(board, initial);
+
+        printf("%-10s depth %d: copy-make %10.0f nps, make/unmake %10.0f nps (x%.2f) %s\n",
+               position.name, position.depth, copy_nodes / copy_seconds, unmake_nodes / unmake_seconds,
+               copy_seconds / unmake_seconds, ok ? "ok" : "MISMATCH");
+
+        if(!ok)
+            mismatch = true;
+    }
+    printf("\n");
+
+    // parallel perft scaling
+    // thread counts: powers of two up to hardware threads (at least 2 - splitting is checked on 1 core too)
+    const int max_threads = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<int> thread_counts;
+    for(int threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    printf("parallel perft (split ply 2, %u hardware threads):\n", std::thread::hardware_concurrency());
+
+    for(const PerftBenchPosition &position : perft_bench_positions){
+        board.load_fen(position.fen);
+        PerftMovesCount serial = perf(position.depth, board);
+
+        double one_thread_seconds = 0.0;
+        for(int threads : thread_counts){
+            auto start = std::chrono::steady_clock::now();
+            PerftMovesCount result = parallel_perf(position.depth, board, threads, 2);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if(threads == 1)
+                one_thread_seconds = seconds;
+
+            bool ok = result == serial;
+            printf("%-10s depth %d, %3d threads: %9.3f s %11.0f nps (x%.2f) %s\n",
+                   position.name, position.depth, threads, seconds, result.count / seconds,
+                   one_thread_seconds / seconds, ok ? "ok" : "MISMATCH");
+
+            if(!ok)
+                mismatch = true;
+        }
+    }
+    printf("\n");
+
+    // legal generator vs copy-make reference
+    printf("legal generator validation:\n");
+
+    for(const PerftBenchPosition &position : perft_validation_positions){
+        board.load_fen(position.fen);
+
+        unsigned long long nodes = perf(position.depth, board).count;
+        unsigned long long reference_nodes = reference_perft(position.depth, board);
+        bool ok = nodes == position.expected && reference_nodes == position.expected;
+
+        printf("%-20s depth %d: %10llu nodes (copy-make %10llu, expected %10llu) %s\n",
+               position.name, position.depth, nodes, reference_nodes, position.expected, ok ? "ok" : "MISMATCH");
+
+        if(!ok)
+            mismatch = true;
+    }
+
+    // generator modes (quiescence search, staged move picker)
+    printf("\ngenerator modes validation:\n");
+
+    for(const PerftBenchPosition &position : perft_bench_positions){
+        board.load_fen(position.fen);
+
+        unsigned long long captures = 0;
+        unsigned long long mismatches = generator_mode_mismatches(3, board, MoveList(), MoveList(), captures);
+
+        printf("%-20s depth 3: %10llu captures generated, %llu mismatching nodes %s\n",
+               position.name, captures, mismatches, mismatches == 0 ? "ok" : "MISMATCH");
+
+        if(mismatches)
+            mismatch = true;
+    }
+
+    return mismatch ? 1 : 0;
+}
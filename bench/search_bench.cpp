@@ -0,0 +1,100 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "attacks.hpp"
+#include "board.hpp"
+#include "search.hpp"
+#include "bench_positions.hpp"
+
+// ************************************
+// *         SEARCH TIME TO DEPTH
+// ************************************
+// fixed depth search of bench positions without and with transposition table
+// (table cleared before each position - every position searched from scratch)
+// first move cutoffs: share of fail high nodes that failed high on first searched move
+// smp scaling (lazy smp and ybwc): 1/2/4/.../N threads, time to depth and nps relative to 1 thread
+// usage: search_bench [depth] [hash mb] [max threads]
+
+constexpr int DEFAULT_DEPTH = 5;
+
+struct SearchBenchTotals{
+    unsigned long long nodes = 0;
+    double seconds = 0.0;
+    unsigned long long beta_cutoffs = 0;
+    unsigned long long first_move_cutoffs = 0;
+};
+
+SearchBenchTotals run_positions(int depth, int hash_mb, int threads = 1, SmpMode smp_mode = SmpMode::lazy){
+    transposition_table.resize(hash_mb);
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.threads = threads;
+    limits.smp_mode = smp_mode;
+
+    SearchBenchTotals totals;
+    Board board;
+
+    for(const char *fen : bench_positions){
+        board.load_fen(fen);
+        transposition_table.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result = search_best_move(board, limits);
+        totals.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        totals.nodes += result.nodes;
+        totals.beta_cutoffs += result.beta_cutoffs;
+        totals.first_move_cutoffs += result.first_move_cutoffs;
+    }
+
+    printf("hash %4d MB, %3d threads: %12llu nodes %9.3f s %11.0f nps, first move cutoffs %5.1f%%\n",
+           hash_mb, threads, totals.nodes, totals.seconds, totals.nodes / totals.seconds,
+           100.0 * totals.first_move_cutoffs / std::max(totals.beta_cutoffs, 1ULL));
+
+    return totals;
+}
+
+int main(int argc, char const *argv[])
+{
+    const int depth = argc > 1 ? std::stoi(argv[1]) : DEFAULT_DEPTH;
+    const int hash_mb = argc > 2 ? std::stoi(argv[2]) : DEFAULT_HASH_MB;
+    const int max_threads = argc > 3 ? std::stoi(argv[3]) : std::max(2, (int)std::thread::hardware_concurrency());
+
+    init_all_lookup_tables();
+
+    const int positions = sizeof(bench_positions) / sizeof(bench_positions[0]);
+    printf("time to depth %d, %d positions\n\n", depth, positions);
+
+    SearchBenchTotals without_table = run_positions(depth, 0);
+    SearchBenchTotals with_table = run_positions(depth, hash_mb);
+
+    printf("\nnodes: x%.2f less, time: x%.2f faster\n",
+           (double)without_table.nodes / with_table.nodes, without_table.seconds / with_table.seconds);
+
+    std::vector<int> thread_counts;
+    for(int threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    for(SmpMode smp_mode : {SmpMode::lazy, SmpMode::ybwc}){
+        printf("\n%s scaling:\n", smp_mode == SmpMode::lazy ? "lazy smp" : "ybwc");
+
+        SearchBenchTotals single_thread;
+        for(int threads : thread_counts){
+            SearchBenchTotals totals = run_positions(depth, hash_mb, threads, smp_mode);
+            if(threads == 1)
+                single_thread = totals;
+
+            printf("    time to depth x%.2f, nps x%.2f\n", single_thread.seconds / totals.seconds,
+                   (totals.nodes / totals.seconds) / (single_thread.nodes / single_thread.seconds));
+        }
+    }
+
+    transposition_table.resize(DEFAULT_HASH_MB);
+
+    return 0;
+}
@@ -5,6 +5,13 @@
 #include <utility.hpp>
 #include <pieces_weights.hpp>
 
+// nodes visited by minmax / get_best_move (reset by caller)
+extern unsigned long long search_nodes;
+
+// material + psqt (white positive); O(1) - kept incrementally by Board (psqt_score)
 int eval(Board& board);
+// same score summed over all pieces (debug cross-check)
+int eval_from_scratch(Board& board);
 int minmax(Board& board, int depth);
+// fixed depth wrapper of search_best_move (search.hpp)
 Move get_best_move(Board& board, int depth);
\ No newline at end of file
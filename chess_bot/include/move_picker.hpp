@@ -0,0 +1,91 @@
+#pragma once
+
+#include <board.hpp>
+#include <moves.hpp>
+
+#include "pieces_weights.hpp"
+
+// max distance from root (pv table, killers)
+constexpr int MAX_PLY = 128;
+
+// history scores are kept in [-HISTORY_MAX, HISTORY_MAX] (gravity update)
+constexpr int HISTORY_MAX = 16384;
+
+// not generated in captures mode (killers / history apply)
+inline bool is_quiet(const Move &move){
+    const int move_type = move.get_move_type();
+    return !(move_type & static_cast<int>(MoveType::capture)) && move_type != static_cast<int>(MoveType::queen_promotion);
+}
+
+// material won by capture / promotion (en passant captures pawn)
+int capture_gain(const Move &move, const Board &board);
+
+// most valuable victim first, least valuable attacker among equal victims
+int mvv_lva(const Move &move, const Board &board);
+
+// static exchange evaluation: material balance of capture sequence on move's target square
+// (both sides recapture with least valuable attacker, x-rays included)
+int see(const Move &move, Board &board);
+
+// quiet move ordering data kept between nodes of one search
+struct MoveOrdering{
+    // two quiet moves per ply that caused beta cutoff
+    Move killers[MAX_PLY][2];
+    // butterfly history [color][from][to]
+    int history[2][64][64];
+
+    void clear();
+
+    void update_killers(const Move &move, int ply);
+    // cutoff move gets bonus, quiets searched before it get malus
+    void update_history(int color, const Move &move, int bonus);
+};
+
+enum class PickerStage{
+    tt_move,
+    generate_captures,
+    good_captures,
+    killers,
+    generate_quiets,
+    quiets,
+    bad_captures,
+    done
+};
+
+// staged move ordering: hash move, winning / equal captures (MVV-LVA), killers,
+// quiets by history, losing captures (SEE < 0)
+// moves of later stages are generated only when earlier stages didn't cut
+// returned moves are pseudo-legal; Move with encoded_value 0 - no more moves
+class MovePicker{
+public:
+    // main search
+    MovePicker(Board &board, Move tt_move, const MoveOrdering &ordering, int ply);
+    // quiescence search: captures only (all moves when in check)
+    MovePicker(Board &board, bool in_check, const MoveOrdering &ordering);
+
+    Move next();
+
+    inline PickerStage get_stage() const{
+        return stage;
+    }
+
+private:
+    Board &board;
+    const MoveOrdering &ordering;
+    PickerStage stage;
+
+    Move tt_move;
+    Move killers[2];
+    bool captures_only = false;
+
+    MoveList moves;
+    int scores[MAX_MOVES];
+    int current = 0;
+
+    MoveList bad_captures;
+    int current_bad = 0;
+
+    // best scored move from current onwards to front
+    Move pick_best();
+    bool is_special(const Move &move) const;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+#include <cstdlib>
+#include <string>
+
+#include <board.hpp>
+#include <moves.hpp>
+
+#include "chess_bot.hpp"
+#include "transposition_table.hpp"
+#include "move_picker.hpp"
+
+constexpr int MAX_SEARCH_DEPTH = 64;
+
+// scores (side to move relative); must fit in transposition table (int16)
+// mate in n plies from root: MATE_SCORE - n (mated: -MATE_SCORE + n)
+constexpr int MATE_SCORE = 32000;
+constexpr int INF_SCORE = 32001;
+// scores at least this far from zero are mate scores
+constexpr int MATE_IN_MAX_PLY = MATE_SCORE - MAX_PLY;
+
+inline bool is_mate_score(int score){
+    return std::abs(score) >= MATE_IN_MAX_PLY;
+}
+
+// full moves to mate for uci "score mate n" (negative - side to move gets mated)
+inline int mate_in_moves(int score){
+    return score > 0 ? (MATE_SCORE - score + 1) / 2 : -(MATE_SCORE + score) / 2;
+}
+
+// lazy smp / ybwc thread limit
+constexpr int MAX_SEARCH_THREADS = 256;
+// ybwc: nodes closer to leaves than this are never split
+constexpr int YBWC_MIN_SPLIT_DEPTH = 4;
+
+// parallel search mode (threads > 1)
+enum class SmpMode{
+    // helpers run own iterative deepening, sharing transposition table
+    lazy,
+    // young brothers wait: after first move of non-pv node, remaining moves are searched by idle helpers
+    ybwc
+};
+
+// every tunable search parameter (SPRT tuning); margins in centipawns
+struct SearchParams{
+    // aspiration window around previous iteration's score (doubled on fail)
+    int aspiration_window = 25;
+    int aspiration_min_depth = 4;
+
+    // quiescence delta pruning margin (capture can't raise alpha by more than this over its material)
+    int delta_margin = 200;
+
+    // plies added to moves giving check
+    int check_extension = 1;
+
+    // null move pruning, reduction: null_move_reduction + depth / null_move_depth_divisor
+    int null_move_min_depth = 3;
+    int null_move_reduction = 3;
+    int null_move_depth_divisor = 4;
+
+    // reverse futility pruning: static eval - rfp_margin * depth >= beta
+    int rfp_max_depth = 6;
+    int rfp_margin = 80;
+
+    // futility pruning of quiet moves: static eval + futility_base + futility_margin * depth <= alpha
+    int futility_max_depth = 3;
+    int futility_base = 50;
+    int futility_margin = 100;
+
+    // late move reductions: lmr_base / 100 + ln(depth) * ln(move number) / (lmr_divisor / 100)
+    // first lmr_min_move moves of node are never reduced
+    int lmr_min_depth = 3;
+    int lmr_min_move = 3;
+    int lmr_base = 75;
+    int lmr_divisor = 225;
+};
+
+extern SearchParams search_params;
+
+// sets parameter by field name (tuning scripts); false if there is no such parameter
+bool set_search_param(const std::string &name, int value);
+
+// time reserved for move overhead (ms)
+constexpr int MOVE_OVERHEAD_MS = 10;
+// moves to go assumed when clock has no movestogo
+constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+// what to search: depth and / or time (all times in ms, 0 - not used)
+struct SearchLimits{
+    int depth = MAX_SEARCH_DEPTH;
+
+    // fixed time per move
+    int movetime = 0;
+
+    // clock (used when movetime == 0)
+    int wtime = 0;
+    int btime = 0;
+    int winc = 0;
+    int binc = 0;
+    int movestogo = 0;
+
+    // main thread + (threads - 1) helpers
+    int threads = 1;
+    SmpMode smp_mode = SmpMode::lazy;
+
+    // print info line after every completed iteration
+    bool print_info = false;
+};
+
+struct SearchResult{
+    Move best_move;
+    // main thread's result; nodes and cutoff statistics are totals of all threads
+    // side to move relative score of last completed iteration
+    int score = 0;
+    // last completed depth
+    int depth = 0;
+    // principal variation of last completed iteration
+    std::vector<Move> pv;
+    unsigned long long nodes = 0;
+    double seconds = 0.0;
+
+    // fail high nodes, and how many of them failed high on first move (move ordering quality)
+    unsigned long long beta_cutoffs = 0;
+    unsigned long long first_move_cutoffs = 0;
+};
+
+// shared by all searches (kept between moves)
+extern TranspositionTable transposition_table;
+
+// iterative deepening search
+// soft deadline: no new iteration is started after it
+// hard deadline: running iteration is aborted, best move of last completed depth is returned
+SearchResult search_best_move(Board &board, const SearchLimits &limits);
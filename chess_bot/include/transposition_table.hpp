@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include <moves.hpp>
+
+// ************************************
+// *      TRANSPOSITION TABLE
+// ************************************
+// 16-byte entries, 4 per 64-byte bucket (one cache line)
+// lockless: key is stored XORed with data, torn entry fails key check
+// replacement: same key, else entry with lowest depth (older searches first)
+
+enum class Bound : uint8_t{
+    none = 0,
+    // score <= real value
+    lower = 1,
+    // score >= real value
+    upper = 2,
+    exact = 3
+};
+
+struct TTData{
+    Move move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::none;
+};
+
+struct TTEntry{
+    std::atomic<U64> key_xor_data{0};
+    std::atomic<U64> data{0};
+};
+
+constexpr int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket{
+    TTEntry entries[TT_BUCKET_SIZE];
+};
+
+constexpr size_t DEFAULT_HASH_MB = 16;
+
+class TranspositionTable{
+public:
+    explicit TranspositionTable(size_t size_mb = DEFAULT_HASH_MB);
+
+    // 0 MB - table disabled (probe always misses)
+    void resize(size_t size_mb);
+    void clear();
+
+    // called at start of every search (entries of older searches are replaced first)
+    void new_search();
+
+    bool probe(U64 key, TTData &data) const;
+    void store(U64 key, Move move, int score, int depth, Bound bound);
+
+    inline void prefetch(U64 key) const{
+        if(!buckets.empty())
+            __builtin_prefetch(&buckets[key & bucket_mask]);
+    }
+
+    // permille of sampled entries written in current search
+    int hashfull() const;
+
+    inline size_t size() const{ return buckets.size() * TT_BUCKET_SIZE; }
+
+private:
+    std::vector<TTBucket> buckets;
+    size_t bucket_mask = 0;
+    uint8_t age = 0;
+};
@@ -1,6 +1,21 @@
+#include <climits>
+#include <stdexcept>
+
 #include "chess_bot.hpp"
+#include "search.hpp"
+
+unsigned long long search_nodes = 0;
 
 int eval(Board& board){
+#ifdef ENGINE_VERIFY_HASH
+    if(board.psqt_score != eval_from_scratch(board))
+        throw std::runtime_error("Incremental eval mismatch");
+#endif
+
+    return board.psqt_score;
+}
+
+int eval_from_scratch(Board& board){
     // todo napisać funckje evaluacji bazową dla testu
     // // iterujemy po wszystkich typach figur (12 bitboardów)
 
@@ -57,10 +72,18 @@ int eval(Board& board){
 }
 
 int minmax(Board& board, int depth){
+    search_nodes++;
+
+    // computed once per node, legal moves are generated only for leaves in check
+    const bool in_check = isKingUnderAttack(board);
+
     if(depth == 0){
         // board.print_board_ascii(board);
-        if(isCheckMate(board)){
-            return board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
+        if(in_check){
+            MoveList evasions;
+            generate_legal_moves(board, evasions);
+            if(evasions.size() == 0)
+                return board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
         }
 
         return eval(board);
@@ -69,15 +92,18 @@ int minmax(Board& board, int depth){
     int best_eval = board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
     bool success = false;
 
-    auto moves = generate_moves(board);
+    MoveList moves;
+    generate_moves(board, moves);
 
     for(Move& move : moves){
-        Board copy_board = board;
-        make_move(move, copy_board);
+        push_move(move, board);
 
         // isLegal
-        if(!isKingUnderAttack(copy_board, true)){
-            int e = minmax(copy_board, depth-1);
+        bool is_legal = !isKingUnderAttack(board, true);
+        int e = is_legal ? minmax(board, depth-1) : 0;
+        pop_move(board);
+
+        if(is_legal){
 
             // check for better evaluation (better than best_eval)
             if ((board.color_to_move == static_cast<int>(COLOR::white) && e > best_eval) ||
@@ -90,68 +116,8 @@ int minmax(Board& board, int depth){
 
     // if no legal moves
     if(success == false){
-        //checkmate
-        if(!isCheckMate(board)){
-            // stale mate
-            // board.print_board_ascii(board);
-            // throw std::runtime_error("No legal moves!");
-            return 0;
-        }
-
-        // white or black win (max value for white, min value for black)
-        // return board.color_to_move == static_cast<int>(COLOR::white) ? INT_MAX : INT_MIN;
-        return best_eval;
-    }
-
-    return best_eval;
-}
-
-// alpha -> maxi
-// beta -> mini
-int minmax_alpha_beta(Board& board, int depth, int alpha, int beta){
-    if(depth == 0){
-        if(isCheckMate(board)){
-            return board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
-        }
-
-        return eval(board);
-    }
-    
-    int best_eval = board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
-    bool success = false;
-
-    auto moves = generate_moves(board);
-
-    for(Move& move : moves){
-        Board copy_board = board;
-        make_move(move, copy_board);
-
-        // isLegal
-        if(!isKingUnderAttack(copy_board, true)){
-            int e = minmax_alpha_beta(copy_board, depth-1, alpha, beta);
-
-            // check for better evaluation (better than best_eval)
-            if(board.color_to_move == static_cast<int>(COLOR::white)){
-                best_eval = std::max(best_eval, e);
-                alpha = std::max(alpha, e);
-                success = true;
-            }
-            else{
-                
-                best_eval = std::min(best_eval, e);
-                beta = std::min(beta, e);
-                success = true;
-            }
-
-            if(alpha >= beta)
-                break;
-        }
-    }
-
-    // if no legal moves
-    if(success == false){
-        //checkmate
-        if(!isCheckMate(board)){
+        // no legal move found by loop - checkmate if in check
+        if(!in_check){
             // stale mate
             // board.print_board_ascii(board);
             // throw std::runtime_error("No legal moves!");
@@ -166,38 +132,13 @@ int minmax_alpha_beta(Board& board, int depth, int alpha, int beta){
     return best_eval;
 }
 
-
+// fixed depth search (iterative deepening up to depth + 1 plies: root move + depth)
 Move get_best_move(Board& board, int depth){
-    auto moves = generate_moves(board);
-    int best_eval = board.color_to_move == static_cast<int>(COLOR::white) ? INT_MIN : INT_MAX;
-    Move best_move;
+    SearchLimits limits;
+    limits.depth = depth + 1;
 
-    int alpha = INT_MIN;
-    int beta = INT_MAX;
+    SearchResult result = search_best_move(board, limits);
+    search_nodes += result.nodes;
 
-    // find best move
-    for(Move& move : moves){
-        Board copy_board = board;
-        make_move(move, copy_board);
-
-        int e = minmax_alpha_beta(copy_board, depth, alpha, beta);
-        // int e = minmax(copy_board, depth);
-        
-        if(board.color_to_move == static_cast<int>(COLOR::white) && e > alpha){
-            // if( e > alpha)
-            alpha = e;
-
-            // best_eval = e;
-            best_move = move;
-        }
-        else if(board.color_to_move == static_cast<int>(COLOR::black) && e < beta){
-            // if( e < beta)
-            beta = e;
-
-            // best_eval = e;
-            best_move = move;
-        }
-    }
-
-    return best_move;
-}
\ No newline at end of file
+    return result.best_move;
+}
@@ -9,6 +9,7 @@
 #include <moves.hpp>
 
 #include "chess_bot.hpp"
+#include "search.hpp"
 
 //todo zmienić nazwy plików .hpp, dodać namespace i ogarnać sprawę includeów
 
@@ -17,7 +18,7 @@ int main(int argc, char const *argv[])
     std::cout << "Dziala\n";
 
     Board board;
-    init_all_lookup_tables(board);
+    init_all_lookup_tables();
 
     board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     // board.load_fen("k7/8/8/8/3r1n2/4P3/8/K7 w - - 0 1");    // bicie wierzy e3xd4
@@ -25,10 +26,16 @@ int main(int argc, char const *argv[])
 
     // printf("fen 1: %d\n", eval(board));
 
-    for(int i = 0; i < 10; i++){
-        printf("%d: ", i);
-        get_best_move(board, i).print();
-    }
+    // usage: chess_bot_test [movetime ms] [threads] [lazy | ybwc]
+    SearchLimits limits;
+    limits.movetime = argc > 1 ? std::stoi(argv[1]) : 5000;
+    limits.threads = argc > 2 ? std::stoi(argv[2]) : 1;
+    limits.smp_mode = argc > 3 && std::string(argv[3]) == "ybwc" ? SmpMode::ybwc : SmpMode::lazy;
+    limits.print_info = true;
+
+    SearchResult result = search_best_move(board, limits);
+    printf("bestmove %s (depth %d, %llu nodes, %.3f s)\n",
+           result.best_move.to_uci().c_str(), result.depth, result.nodes, result.seconds);
     // get_best_move(board, 2).second.print();
 
 
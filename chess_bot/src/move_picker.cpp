@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <attacks.hpp>
+
+#include "move_picker.hpp"
+
+// attacker order for MVV-LVA (index: piece type P, R, N, B, Q, K)
+constexpr int LVA_ORDER[6] = {0, 3, 1, 2, 4, 5};
+
+// piece types from least to most valuable (SEE attacker choice)
+constexpr int SEE_ATTACKER_ORDER[6] = {
+    static_cast<int>(PIECE::P), static_cast<int>(PIECE::N), static_cast<int>(PIECE::B),
+    static_cast<int>(PIECE::R), static_cast<int>(PIECE::Q), static_cast<int>(PIECE::K)
+};
+
+int capture_gain(const Move &move, const Board &board){
+    const int move_type = move.get_move_type();
+    int gain = 0;
+
+    if(move_type == static_cast<int>(MoveType::en_passant_capture))
+        gain = PIECE_VALUE[static_cast<int>(PIECE::P)];
+    else if(move_type & static_cast<int>(MoveType::capture))
+        gain = PIECE_VALUE[board.piece_on_square(move.get_to_square()) % 6];
+
+    if(move_type & static_cast<int>(MoveType::knight_promotion))
+        gain += PIECE_VALUE[promotion_piece[move_type & 0b11]] - PIECE_VALUE[static_cast<int>(PIECE::P)];
+
+    return gain;
+}
+
+int mvv_lva(const Move &move, const Board &board){
+    return capture_gain(move, board) * 8 - LVA_ORDER[move.get_piece() % 6];
+}
+
+// pieces of both colors attacking square with given occupancy
+inline U64 attackers_to(int square, U64 occupancy, const Board &board){
+    const U64 *bb = board.bitboards;
+    return (pawn_lookup_attacks[static_cast<int>(COLOR::black)][square] & bb[static_cast<int>(PIECE::P)]) |
+           (pawn_lookup_attacks[static_cast<int>(COLOR::white)][square] & bb[static_cast<int>(PIECE::p)]) |
+           (knight_lookup_attacks[square] & (bb[static_cast<int>(PIECE::N)] | bb[static_cast<int>(PIECE::n)])) |
+           (king_lookup_attacks[square] & (bb[static_cast<int>(PIECE::K)] | bb[static_cast<int>(PIECE::k)])) |
+           (bishop_attacks(square, occupancy) & (bb[static_cast<int>(PIECE::B)] | bb[static_cast<int>(PIECE::b)] |
+                                                 bb[static_cast<int>(PIECE::Q)] | bb[static_cast<int>(PIECE::q)])) |
+           (rook_attacks(square, occupancy) & (bb[static_cast<int>(PIECE::R)] | bb[static_cast<int>(PIECE::r)] |
+                                               bb[static_cast<int>(PIECE::Q)] | bb[static_cast<int>(PIECE::q)]));
+}
+
+int see(const Move &move, Board &board){
+    const int move_type = move.get_move_type();
+    if(move_type == static_cast<int>(MoveType::king_castle) || move_type == static_cast<int>(MoveType::queen_castle))
+        return 0;
+
+    const int from_square = move.get_from_square();
+    const int to_square = move.get_to_square();
+
+    // gain[d] - material balance for side making capture d if sequence stopped there
+    int gain[32];
+    int d = 0;
+    gain[0] = capture_gain(move, board);
+
+    // value of piece standing on target square after capture
+    int piece_value = move_type & static_cast<int>(MoveType::knight_promotion) ?
+        PIECE_VALUE[promotion_piece[move_type & 0b11]] : PIECE_VALUE[move.get_piece() % 6];
+
+    U64 occupancy = board.both_occupancy_bitboard ^ (1ULL << from_square);
+    if(move_type == static_cast<int>(MoveType::en_passant_capture))
+        occupancy ^= 1ULL << (board.color_to_move == static_cast<int>(COLOR::white) ? to_square - 8 : to_square + 8);
+
+    int side = !board.color_to_move;
+
+    while(d < 31){
+        // removed pieces drop out, sliders behind them (x-rays) come in
+        U64 attackers = attackers_to(to_square, occupancy, board) & occupancy & board.color_occupancy_bitboards[side];
+        if(!attackers)
+            break;
+
+        int attacker_type = 0;
+        U64 attacker_bitboard = 0ULL;
+        for(int type : SEE_ATTACKER_ORDER){
+            attacker_bitboard = attackers & board.bitboards[type + side * 6];
+            if(attacker_bitboard){
+                attacker_type = type;
+                break;
+            }
+        }
+
+        d++;
+        gain[d] = piece_value - gain[d - 1];
+        piece_value = PIECE_VALUE[attacker_type];
+
+        occupancy ^= attacker_bitboard & -attacker_bitboard;
+        side = !side;
+    }
+
+    // each side may stop capturing when continuing loses material
+    while(d > 0){
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+
+    return gain[0];
+}
+
+void MoveOrdering::clear(){
+    std::memset(killers, 0, sizeof(killers));
+    std::memset(history, 0, sizeof(history));
+}
+
+void MoveOrdering::update_killers(const Move &move, int ply){
+    if(!is_quiet(move) || killers[ply][0].encoded_value == move.encoded_value)
+        return;
+
+    killers[ply][1] = killers[ply][0];
+    killers[ply][0] = move;
+}
+
+void MoveOrdering::update_history(int color, const Move &move, int bonus){
+    // gravity: entries saturate at HISTORY_MAX
+    int &entry = history[color][move.get_from_square()][move.get_to_square()];
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+MovePicker::MovePicker(Board &board, Move tt_move, const MoveOrdering &ordering, int ply)
+    : board(board), ordering(ordering), stage(PickerStage::tt_move), tt_move(tt_move){
+    killers[0] = ordering.killers[ply][0];
+    killers[1] = ordering.killers[ply][1];
+
+    if(!is_pseudo_legal(tt_move, board)){
+        this->tt_move = Move();
+        stage = PickerStage::generate_captures;
+    }
+}
+
+MovePicker::MovePicker(Board &board, bool in_check, const MoveOrdering &ordering)
+    : board(board), ordering(ordering), stage(PickerStage::generate_captures), captures_only(!in_check){
+}
+
+Move MovePicker::pick_best(){
+    int best_index = current;
+    for(int i = current + 1; i < moves.size(); i++)
+        if(scores[i] > scores[best_index])
+            best_index = i;
+
+    std::swap(moves[current], moves[best_index]);
+    std::swap(scores[current], scores[best_index]);
+
+    return moves[current++];
+}
+
+bool MovePicker::is_special(const Move &move) const{
+    return move.encoded_value == tt_move.encoded_value ||
+           move.encoded_value == killers[0].encoded_value ||
+           move.encoded_value == killers[1].encoded_value;
+}
+
+Move MovePicker::next(){
+    switch(stage){
+        case PickerStage::tt_move:
+            stage = PickerStage::generate_captures;
+            return tt_move;
+
+        case PickerStage::generate_captures:
+            moves.clear();
+            generate_moves(board, moves, GenType::captures);
+            for(int i = 0; i < moves.size(); i++)
+                scores[i] = mvv_lva(moves[i], board);
+            current = 0;
+            stage = PickerStage::good_captures;
+            [[fallthrough]];
+
+        case PickerStage::good_captures:
+            while(current < moves.size()){
+                Move move = pick_best();
+                if(move.encoded_value == tt_move.encoded_value)
+                    continue;
+
+                // capture of at least as valuable piece can't lose material - SEE only for the rest
+                if(capture_gain(move, board) < PIECE_VALUE[move.get_piece() % 6] && see(move, board) < 0){
+                    bad_captures.push_back(move);
+                    continue;
+                }
+
+                return move;
+            }
+            stage = captures_only ? PickerStage::bad_captures : PickerStage::killers;
+            current = 0;
+            return next();
+
+        case PickerStage::killers:
+            while(current < 2){
+                Move move = killers[current++];
+                if(move.encoded_value && move.encoded_value != tt_move.encoded_value && is_pseudo_legal(move, board))
+                    return move;
+            }
+            stage = PickerStage::generate_quiets;
+            [[fallthrough]];
+
+        case PickerStage::generate_quiets:
+            moves.clear();
+            generate_moves(board, moves, GenType::quiets);
+            for(int i = 0; i < moves.size(); i++)
+                scores[i] = ordering.history[board.color_to_move][moves[i].get_from_square()][moves[i].get_to_square()];
+            current = 0;
+            stage = PickerStage::quiets;
+            [[fallthrough]];
+
+        case PickerStage::quiets:
+            while(current < moves.size()){
+                Move move = pick_best();
+                if(!is_special(move))
+                    return move;
+            }
+            stage = PickerStage::bad_captures;
+            [[fallthrough]];
+
+        case PickerStage::bad_captures:
+            if(current_bad < bad_captures.size())
+                return bad_captures[current_bad++];
+            stage = PickerStage::done;
+            [[fallthrough]];
+
+        case PickerStage::done:
+            break;
+    }
+
+    return Move();
+}
@@ -0,0 +1,819 @@
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "search.hpp"
+
+TranspositionTable transposition_table;
+SearchParams search_params;
+
+// tunable parameters by name
+constexpr std::pair<const char *, int SearchParams::*> SEARCH_PARAM_NAMES[] = {
+    {"aspiration_window", &SearchParams::aspiration_window},
+    {"aspiration_min_depth", &SearchParams::aspiration_min_depth},
+    {"delta_margin", &SearchParams::delta_margin},
+    {"check_extension", &SearchParams::check_extension},
+    {"null_move_min_depth", &SearchParams::null_move_min_depth},
+    {"null_move_reduction", &SearchParams::null_move_reduction},
+    {"null_move_depth_divisor", &SearchParams::null_move_depth_divisor},
+    {"rfp_max_depth", &SearchParams::rfp_max_depth},
+    {"rfp_margin", &SearchParams::rfp_margin},
+    {"futility_max_depth", &SearchParams::futility_max_depth},
+    {"futility_base", &SearchParams::futility_base},
+    {"futility_margin", &SearchParams::futility_margin},
+    {"lmr_min_depth", &SearchParams::lmr_min_depth},
+    {"lmr_min_move", &SearchParams::lmr_min_move},
+    {"lmr_base", &SearchParams::lmr_base},
+    {"lmr_divisor", &SearchParams::lmr_divisor},
+};
+
+// late move reductions [depth][move number], from search_params at start of every search
+int lmr_reductions[MAX_SEARCH_DEPTH][MAX_MOVES];
+
+bool set_search_param(const std::string &name, int value){
+    for(const auto &[param_name, member] : SEARCH_PARAM_NAMES){
+        if(name == param_name){
+            search_params.*member = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void init_lmr_reductions(const SearchParams &params){
+    for(int depth = 0; depth < MAX_SEARCH_DEPTH; depth++)
+        for(int move_number = 0; move_number < MAX_MOVES; move_number++)
+            lmr_reductions[depth][move_number] = depth == 0 || move_number == 0 ? 0 :
+                (int)(params.lmr_base / 100.0 + std::log(depth) * std::log(move_number) / (params.lmr_divisor / 100.0));
+}
+
+// nodes between deadline checks
+constexpr unsigned long long TIME_CHECK_NODES = 1024;
+
+// lazy smp helper depth perturbation: helper i skips depths so threads don't search
+// same iteration in lockstep (skip size / phase per helper, cycled)
+constexpr int HELPER_SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr int HELPER_SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// ybwc threads waiting for work sleep on pool condition variable; timeout covers stop flag
+// set by deadline check (no notify) and lets waiting main thread watch deadline
+constexpr auto SPLIT_WAIT_TIMEOUT = std::chrono::milliseconds(1);
+
+// ybwc split point: node whose first move was searched serially, remaining moves
+// are handed out to owner and idle helpers (non-pv nodes only - null window, no re-searches, pv untouched)
+struct SplitPoint{
+    std::mutex mutex;
+
+    // position at split node (helpers search own copies)
+    Board board;
+    int depth = 0;
+    int ply = 0;
+    int alpha = 0;
+    int beta = 0;
+
+    bool in_check = false;
+    CheckInfo check_info;
+    bool futility_pruning = false;
+
+    // remaining pseudo-legal moves (guarded by mutex)
+    MoveList moves;
+    int next_move = 0;
+    // moves searched at node before split (late move reductions)
+    int moves_searched = 0;
+    // quiets searched without cutoff, before and after split (history malus; guarded by mutex)
+    MoveList quiets_searched;
+
+    // result (guarded by mutex)
+    int best_score = -INF_SCORE;
+    Move best_move;
+
+    // enclosing split point of owner - cutoff there aborts this one too
+    SplitPoint *parent = nullptr;
+    std::atomic<bool> cutoff = false;
+    // helpers currently searching moves of this split point
+    std::atomic<int> workers = 0;
+};
+
+// split points open for helpers
+struct SplitPointPool{
+    std::mutex mutex;
+    // signalled when split point is published, worker leaves split point or search stops
+    std::condition_variable changed;
+    std::vector<SplitPoint *> split_points;
+    // helpers waiting for work
+    std::atomic<int> idle_helpers = 0;
+};
+
+// per thread search data (thread 0 - main thread)
+struct SearchState{
+    int thread_id = 0;
+
+    std::chrono::steady_clock::time_point start;
+    // ms; 0 - no limit
+    double soft_limit = 0.0;
+    double hard_limit = 0.0;
+
+    // written only by owning thread, read by main thread (totals)
+    std::atomic<unsigned long long> nodes = 0;
+
+    // shared by all threads; set by main thread (deadline / search finished)
+    std::atomic<bool> *stop = nullptr;
+    // local copy of stop, refreshed every TIME_CHECK_NODES nodes
+    bool stopped = false;
+
+    // move ordering statistics (full width nodes)
+    unsigned long long beta_cutoffs = 0;
+    unsigned long long first_move_cutoffs = 0;
+
+    // killers / history
+    MoveOrdering ordering;
+
+    // triangular principal variation table (pv[ply] - line from ply)
+    Move pv[MAX_PLY][MAX_PLY];
+    int pv_length[MAX_PLY] = {};
+
+    // ybwc mode only
+    SplitPointPool *pool = nullptr;
+    // split point whose moves this thread is searching (nullptr - none)
+    SplitPoint *split_point = nullptr;
+
+    // states of all threads of this search (node totals)
+    const std::vector<std::unique_ptr<SearchState>> *all_states = nullptr;
+
+    double elapsed_ms() const{
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    unsigned long long total_nodes() const{
+        unsigned long long total = 0;
+        for(const auto &state : *all_states)
+            total += state->nodes.load(std::memory_order_relaxed);
+        return total;
+    }
+};
+
+// soft / hard deadlines from movetime or clock of side to move
+void set_time_limits(SearchState &state, const SearchLimits &limits, int color_to_move){
+    if(limits.movetime > 0){
+        state.soft_limit = state.hard_limit = std::max(1, limits.movetime - MOVE_OVERHEAD_MS);
+        return;
+    }
+
+    const int time = color_to_move == static_cast<int>(COLOR::white) ? limits.wtime : limits.btime;
+    const int increment = color_to_move == static_cast<int>(COLOR::white) ? limits.winc : limits.binc;
+    if(time <= 0)
+        return;
+
+    const int moves_to_go = limits.movestogo > 0 ? limits.movestogo : DEFAULT_MOVES_TO_GO;
+    const double available = std::max(1, time - MOVE_OVERHEAD_MS);
+
+    state.soft_limit = std::min(available, (double)time / moves_to_go + increment * 3 / 4);
+    state.hard_limit = std::min(available, state.soft_limit * 4);
+}
+
+// search result can't be used: stopped, or cutoff in split point being searched (or its ancestors)
+inline bool search_aborted(const SearchState &state){
+    if(state.stopped)
+        return true;
+
+    for(const SplitPoint *split_point = state.split_point; split_point; split_point = split_point->parent)
+        if(split_point->cutoff.load(std::memory_order_relaxed))
+            return true;
+
+    return false;
+}
+
+// counts node; true if search must stop (main thread checks hard deadline)
+inline bool count_node(SearchState &state){
+    const unsigned long long nodes = state.nodes.load(std::memory_order_relaxed) + 1;
+    state.nodes.store(nodes, std::memory_order_relaxed);
+
+    if(nodes % TIME_CHECK_NODES == 0){
+        if(state.thread_id == 0 && state.hard_limit > 0 && state.elapsed_ms() >= state.hard_limit)
+            state.stop->store(true, std::memory_order_relaxed);
+        state.stopped = state.stop->load(std::memory_order_relaxed);
+    }
+
+    return search_aborted(state);
+}
+
+// side to move relative evaluation
+inline int evaluate(Board &board){
+    return board.color_to_move == static_cast<int>(COLOR::white) ? eval(board) : -eval(board);
+}
+
+// mate scores in transposition table are relative to stored node
+// (same position reached at other ply is mate in different number of plies from root)
+inline int score_to_tt(int score, int ply){
+    return score >= MATE_IN_MAX_PLY ? score + ply : score <= -MATE_IN_MAX_PLY ? score - ply : score;
+}
+
+inline int score_from_tt(int score, int ply){
+    return score >= MATE_IN_MAX_PLY ? score - ply : score <= -MATE_IN_MAX_PLY ? score + ply : score;
+}
+
+// captures only search below depth 0 (stable leaf values without full width plies)
+// captures in MVV-LVA order, losing captures skipped
+// side to move may stand pat (static eval) unless in check - then all evasions are searched
+// in_check - computed by parent (gives_check of move leading here)
+int quiescence(SearchState &state, Board &board, int ply, int alpha, int beta, bool in_check){
+    if(count_node(state))
+        return 0;
+
+    state.pv_length[ply] = 0;
+
+    int best_score = -INF_SCORE;
+    int stand_pat = -INF_SCORE;
+
+    if(!in_check){
+        stand_pat = evaluate(board);
+        if(stand_pat >= beta || ply >= MAX_PLY - 1)
+            return stand_pat;
+
+        alpha = std::max(alpha, stand_pat);
+        best_score = stand_pat;
+    }
+    else if(ply >= MAX_PLY - 1)
+        return evaluate(board);
+
+    CheckInfo check_info;
+    compute_check_info(board, check_info);
+
+    MovePicker picker(board, in_check, state.ordering);
+    int legal_moves = 0;
+
+    for(Move move = picker.next(); move.encoded_value; move = picker.next()){
+        // losing captures (SEE < 0) are not searched
+        if(!in_check && picker.get_stage() == PickerStage::bad_captures)
+            break;
+
+        // delta pruning: capture can't raise alpha even with margin
+        if(!in_check && stand_pat + capture_gain(move, board) + search_params.delta_margin <= alpha)
+            continue;
+
+        const bool check = gives_check(move, board, check_info);
+        push_move(move, board);
+
+        // isLegal
+        if(isKingUnderAttack(board, true)){
+            pop_move(board);
+            continue;
+        }
+        legal_moves++;
+
+        int score = -quiescence(state, board, ply + 1, -beta, -alpha, check);
+        pop_move(board);
+
+        if(search_aborted(state))
+            return 0;
+
+        if(score > best_score){
+            best_score = score;
+
+            if(score > alpha){
+                alpha = score;
+
+                state.pv[ply][0] = move;
+                std::copy(state.pv[ply + 1], state.pv[ply + 1] + state.pv_length[ply + 1], state.pv[ply] + 1);
+                state.pv_length[ply] = state.pv_length[ply + 1] + 1;
+
+                if(alpha >= beta)
+                    break;
+            }
+        }
+    }
+
+    // checkmate - in check without legal evasion
+    if(in_check && legal_moves == 0)
+        return -MATE_SCORE + ply;
+
+    return best_score;
+}
+
+int negamax(SearchState &state, Board &board, int depth, int ply, int alpha, int beta, bool in_check);
+
+// side to move has non-pawn material (null move is unsafe in pawn endings - zugzwang)
+inline bool has_non_pawn_material(const Board &board, int color){
+    return board.bitboards[static_cast<int>(PIECE::R) + color * 6] | board.bitboards[static_cast<int>(PIECE::N) + color * 6] |
+           board.bitboards[static_cast<int>(PIECE::B) + color * 6] | board.bitboards[static_cast<int>(PIECE::Q) + color * 6];
+}
+
+// search of made move: check extension, late move reduction, pvs null window and re-searches
+// move_number - 1 for first searched move of node
+int search_move(SearchState &state, Board &board, const Move &move, bool gives_check, int depth, int ply,
+                int alpha, int beta, int move_number, bool in_check){
+    const int new_depth = depth - 1 + (gives_check ? search_params.check_extension : 0);
+
+    if(move_number == 1)
+        return -negamax(state, board, new_depth, ply + 1, -beta, -alpha, gives_check);
+
+    int reduction = 0;
+    if(depth >= search_params.lmr_min_depth && move_number > search_params.lmr_min_move &&
+       is_quiet(move) && !in_check && !gives_check){
+        const bool pv_node = beta - alpha > 1;
+        reduction = lmr_reductions[std::min(depth, MAX_SEARCH_DEPTH - 1)][std::min(move_number, MAX_MOVES - 1)] - pv_node;
+        reduction = std::max(0, std::min(reduction, new_depth - 1));
+    }
+
+    int score = -negamax(state, board, new_depth - reduction, ply + 1, -alpha - 1, -alpha, gives_check);
+    if(score > alpha && reduction > 0)
+        score = -negamax(state, board, new_depth, ply + 1, -alpha - 1, -alpha, gives_check);
+    if(score > alpha && score < beta)
+        score = -negamax(state, board, new_depth, ply + 1, -beta, -alpha, gives_check);
+
+    return score;
+}
+
+// futility pruning of node applies to quiet, non-checking moves after first one
+inline bool futility_prunable(bool futility_pruning, const Move &move, bool gives_check, int move_number){
+    return futility_pruning && move_number > 1 && is_quiet(move) && !gives_check;
+}
+
+// quiet cutoff move: killer, history bonus; quiets searched before it: history malus
+void update_quiet_ordering(SearchState &state, int color, const Move &move, int depth, int ply,
+                           const MoveList &quiets_searched){
+    state.ordering.update_killers(move, ply);
+    state.ordering.update_history(color, move, depth * depth);
+    for(const Move &quiet : quiets_searched)
+        if(quiet.encoded_value != move.encoded_value)
+            state.ordering.update_history(color, quiet, -depth * depth);
+}
+
+// searches moves of split point (null window) until none are left or one cuts off
+// per move logic same as serial move loop of negamax (futility, quiets for history)
+void search_split_point(SearchState &state, Board &board, SplitPoint &split_point){
+    while(true){
+        Move move;
+        int move_number;
+        {
+            std::lock_guard<std::mutex> lock(split_point.mutex);
+            if(split_point.cutoff || split_point.next_move == split_point.moves.size())
+                break;
+            move = split_point.moves[split_point.next_move++];
+            move_number = split_point.moves_searched + split_point.next_move;
+        }
+
+        const bool check = gives_check(move, board, split_point.check_info);
+        push_move(move, board);
+
+        // isLegal
+        if(isKingUnderAttack(board, true)){
+            pop_move(board);
+            continue;
+        }
+
+        if(futility_prunable(split_point.futility_pruning, move, check, move_number)){
+            pop_move(board);
+            continue;
+        }
+
+        int score = search_move(state, board, move, check, split_point.depth, split_point.ply,
+                                split_point.alpha, split_point.beta, move_number, split_point.in_check);
+        pop_move(board);
+
+        if(search_aborted(state))
+            break;
+
+        std::lock_guard<std::mutex> lock(split_point.mutex);
+        if(score > split_point.best_score){
+            split_point.best_score = score;
+            split_point.best_move = move;
+            if(score >= split_point.beta)
+                split_point.cutoff = true;
+        }
+        if(score < split_point.beta && is_quiet(move))
+            split_point.quiets_searched.push_back(move);
+    }
+}
+
+// split point is (indirect) child of ancestor - searched for ancestor's owner
+inline bool descends_from(const SplitPoint *split_point, const SplitPoint *ancestor){
+    for(const SplitPoint *parent = split_point->parent; parent; parent = parent->parent)
+        if(parent == ancestor)
+            return true;
+    return false;
+}
+
+// deepest split point with moves left; ancestor != nullptr - only split points below it
+// (pool mutex held by caller)
+SplitPoint *find_open_split_point(SplitPointPool &pool, const SplitPoint *ancestor){
+    SplitPoint *chosen = nullptr;
+    for(SplitPoint *split_point : pool.split_points){
+        if(ancestor && !descends_from(split_point, ancestor))
+            continue;
+
+        std::lock_guard<std::mutex> split_point_lock(split_point->mutex);
+        if(!split_point->cutoff && split_point->next_move < split_point->moves.size() &&
+           (!chosen || split_point->depth > chosen->depth))
+            chosen = split_point;
+    }
+    return chosen;
+}
+
+// worker side: searches moves of split point (workers already counted), then leaves it
+// and wakes thread waiting for its workers
+void join_split_point(SearchState &state, SplitPointPool &pool, SplitPoint &split_point){
+    Board board = split_point.board;
+    SplitPoint *previous = state.split_point;
+    state.split_point = &split_point;
+    search_split_point(state, board, split_point);
+    state.split_point = previous;
+
+    // under pool mutex - owner checks workers there before waiting
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        split_point.workers--;
+    }
+    pool.changed.notify_all();
+}
+
+// owner side of split: remaining moves of picker go to split point, owner searches them
+// together with helpers and waits until every helper has left
+// quiets_searched - in: quiets searched before split, out: all quiets searched without cutoff
+void split(SearchState &state, Board &board, MovePicker &picker, int depth, int ply, int alpha, int beta,
+           bool in_check, const CheckInfo &check_info, bool futility_pruning, int moves_searched,
+           MoveList &quiets_searched, int &best_score, Move &best_move){
+    SplitPoint split_point;
+    split_point.board = board;
+    split_point.depth = depth;
+    split_point.ply = ply;
+    split_point.alpha = alpha;
+    split_point.beta = beta;
+    split_point.in_check = in_check;
+    split_point.check_info = check_info;
+    split_point.futility_pruning = futility_pruning;
+    split_point.moves_searched = moves_searched;
+    split_point.quiets_searched = quiets_searched;
+    split_point.best_score = best_score;
+    split_point.best_move = best_move;
+    split_point.parent = state.split_point;
+    for(Move move = picker.next(); move.encoded_value; move = picker.next())
+        split_point.moves.push_back(move);
+
+    SplitPointPool &pool = *state.pool;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.split_points.push_back(&split_point);
+    }
+    pool.changed.notify_all();
+
+    SplitPoint *previous = state.split_point;
+    state.split_point = &split_point;
+    search_split_point(state, board, split_point);
+    state.split_point = previous;
+
+    // no helper can join after removal
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.split_points.erase(std::find(pool.split_points.begin(), pool.split_points.end(), &split_point));
+    }
+
+    // helpful master: until own helpers are done, owner works at split points opened below this one
+    // (those are searched for it - it can't get stuck there)
+    {
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        while(split_point.workers > 0){
+            if(SplitPoint *chosen = find_open_split_point(pool, &split_point)){
+                chosen->workers++;
+                lock.unlock();
+                join_split_point(state, pool, *chosen);
+                lock.lock();
+                continue;
+            }
+
+            pool.changed.wait_for(lock, SPLIT_WAIT_TIMEOUT);
+
+            // main thread keeps watching deadline
+            if(state.thread_id == 0 && state.hard_limit > 0 && state.elapsed_ms() >= state.hard_limit)
+                state.stop->store(true, std::memory_order_relaxed);
+        }
+    }
+
+    best_score = split_point.best_score;
+    best_move = split_point.best_move;
+    quiets_searched = split_point.quiets_searched;
+}
+
+// ybwc helper: joins deepest open split point until search is stopped
+void ybwc_helper(SearchState &state){
+    SplitPointPool &pool = *state.pool;
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.idle_helpers++;
+
+    while(!state.stop->load(std::memory_order_relaxed)){
+        SplitPoint *chosen = find_open_split_point(pool, nullptr);
+        if(!chosen){
+            // sleeps until split point is published (timeout - stop set without notify)
+            pool.changed.wait_for(lock, SPLIT_WAIT_TIMEOUT);
+            continue;
+        }
+
+        chosen->workers++;
+        pool.idle_helpers--;
+        lock.unlock();
+
+        join_split_point(state, pool, *chosen);
+
+        lock.lock();
+        pool.idle_helpers++;
+    }
+
+    pool.idle_helpers--;
+}
+
+// negamax with principal variation search: first move with full window,
+// rest with null window (re-searched with full window when it fails high)
+// selectivity: reverse futility, null move, futility pruning, late move reductions, check extensions
+// in_check - computed by parent (gives_check of move leading here), terminal nodes are
+// recognized by move loop finding no legal move
+int negamax(SearchState &state, Board &board, int depth, int ply, int alpha, int beta, bool in_check){
+    if(depth <= 0 || ply >= MAX_PLY - 1)
+        return quiescence(state, board, ply, alpha, beta, in_check);
+
+    if(count_node(state))
+        return 0;
+
+    state.pv_length[ply] = 0;
+
+    const bool pv_node = beta - alpha > 1;
+
+    // mate distance pruning: shorter mate was already found
+    if(ply > 0){
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if(alpha >= beta)
+            return alpha;
+    }
+
+    // transposition table cutoff (not in pv nodes - pv stays complete)
+    TTData tt_data;
+    const bool tt_hit = transposition_table.probe(board.hash_key, tt_data);
+    if(!pv_node && tt_hit && tt_data.depth >= depth){
+        const int tt_score = score_from_tt(tt_data.score, ply);
+        if(tt_data.bound == Bound::exact ||
+           (tt_data.bound == Bound::lower && tt_score >= beta) ||
+           (tt_data.bound == Bound::upper && tt_score <= alpha))
+            return tt_score;
+    }
+
+    const int static_eval = in_check ? -INF_SCORE : evaluate(board);
+    const bool mate_bounds = is_mate_score(beta);
+
+    if(!pv_node && !in_check && !mate_bounds){
+        // reverse futility: static eval beats beta by margin that can't be lost in few plies
+        if(depth <= search_params.rfp_max_depth && static_eval - search_params.rfp_margin * depth >= beta)
+            return static_eval;
+
+        // null move: passing still fails high - position is good enough to prune
+        // (not twice in a row, not in pawn endings)
+        const bool after_null_move = !board.history.empty() && board.history.back().move == 0;
+        if(depth >= search_params.null_move_min_depth && static_eval >= beta && !after_null_move &&
+           has_non_pawn_material(board, board.color_to_move)){
+            const int reduction = search_params.null_move_reduction + depth / search_params.null_move_depth_divisor;
+
+            push_null_move(board);
+            int score = -negamax(state, board, depth - 1 - reduction, ply + 1, -beta, -beta + 1, false);
+            pop_null_move(board);
+
+            if(search_aborted(state))
+                return 0;
+            if(score >= beta)
+                return score >= MATE_IN_MAX_PLY ? beta : score;
+        }
+    }
+
+    // quiet moves can't raise alpha near leaves
+    const bool futility_pruning = !pv_node && !in_check && depth <= search_params.futility_max_depth &&
+        static_eval + search_params.futility_base + search_params.futility_margin * depth <= alpha;
+
+    const int original_alpha = alpha;
+    int best_score = -INF_SCORE;
+    Move best_move;
+    int legal_moves = 0;
+
+    CheckInfo check_info;
+    compute_check_info(board, check_info);
+
+    MovePicker picker(board, tt_hit ? tt_data.move : Move(), state.ordering, ply);
+    // quiets searched before cutoff move (history malus)
+    MoveList quiets_searched;
+
+    for(Move move = picker.next(); move.encoded_value; move = picker.next()){
+        const bool check = gives_check(move, board, check_info);
+        push_move(move, board);
+        transposition_table.prefetch(board.hash_key);
+
+        // isLegal
+        if(isKingUnderAttack(board, true)){
+            pop_move(board);
+            continue;
+        }
+        legal_moves++;
+
+        if(futility_prunable(futility_pruning, move, check, legal_moves)){
+            pop_move(board);
+            continue;
+        }
+
+        int score = search_move(state, board, move, check, depth, ply, alpha, beta, legal_moves, in_check);
+        pop_move(board);
+
+        if(search_aborted(state))
+            return 0;
+
+        if(score > best_score){
+            best_score = score;
+            best_move = move;
+
+            if(score > alpha){
+                alpha = score;
+
+                // pv = move + child's pv
+                state.pv[ply][0] = move;
+                std::copy(state.pv[ply + 1], state.pv[ply + 1] + state.pv_length[ply + 1], state.pv[ply] + 1);
+                state.pv_length[ply] = state.pv_length[ply + 1] + 1;
+
+                if(alpha >= beta){
+                    state.beta_cutoffs++;
+                    state.first_move_cutoffs += legal_moves == 1;
+
+                    if(is_quiet(move))
+                        update_quiet_ordering(state, board.color_to_move, move, depth, ply, quiets_searched);
+                    break;
+                }
+            }
+        }
+
+        if(is_quiet(move))
+            quiets_searched.push_back(move);
+
+        // ybwc: first move searched serially, remaining moves shared with idle helpers
+        if(state.pool && !pv_node && depth >= YBWC_MIN_SPLIT_DEPTH && state.pool->idle_helpers.load(std::memory_order_relaxed) > 0){
+            split(state, board, picker, depth, ply, alpha, beta, in_check, check_info, futility_pruning,
+                  legal_moves, quiets_searched, best_score, best_move);
+            if(search_aborted(state))
+                return 0;
+
+            if(best_score >= beta){
+                state.beta_cutoffs++;
+                if(is_quiet(best_move))
+                    update_quiet_ordering(state, board.color_to_move, best_move, depth, ply, quiets_searched);
+            }
+            break;
+        }
+    }
+
+    // no legal moves - checkmate (mated in ply plies from root) or stalemate
+    if(legal_moves == 0)
+        return in_check ? -MATE_SCORE + ply : 0;
+
+    Bound bound = best_score <= original_alpha ? Bound::upper : best_score >= beta ? Bound::lower : Bound::exact;
+    transposition_table.store(board.hash_key, best_move, score_to_tt(best_score, ply), depth, bound);
+
+    return best_score;
+}
+
+// root search in window around previous iteration's score, widened on fail low / high
+int aspiration_search(SearchState &state, Board &board, int depth, int previous_score){
+    int delta = search_params.aspiration_window;
+    int alpha = -INF_SCORE;
+    int beta = INF_SCORE;
+    const bool in_check = isKingUnderAttack(board);
+
+    if(depth >= search_params.aspiration_min_depth && !is_mate_score(previous_score)){
+        alpha = std::max(previous_score - delta, -INF_SCORE);
+        beta = std::min(previous_score + delta, INF_SCORE);
+    }
+
+    while(true){
+        int score = negamax(state, board, depth, 0, alpha, beta, in_check);
+        if(state.stopped)
+            return 0;
+
+        if(score <= alpha && alpha > -INF_SCORE)
+            alpha = std::max(score - delta, -INF_SCORE);
+        else if(score >= beta && beta < INF_SCORE)
+            beta = std::min(score + delta, INF_SCORE);
+        else
+            return score;
+
+        delta *= 2;
+    }
+}
+
+// iterative deepening of one thread; only main thread prints info
+void iterative_deepening(SearchState &state, Board &board, const SearchLimits &limits, SearchResult &result){
+    const int skip_size = state.thread_id ? HELPER_SKIP_SIZE[(state.thread_id - 1) % 20] : 1;
+    const int skip_phase = state.thread_id ? HELPER_SKIP_PHASE[(state.thread_id - 1) % 20] : 0;
+
+    for(int depth = 1; depth <= std::min(limits.depth, MAX_SEARCH_DEPTH); depth++){
+        if(state.thread_id && ((depth + skip_phase) / skip_size) % 2)
+            continue;
+
+        int score = aspiration_search(state, board, depth, result.score);
+        if(state.stopped || state.pv_length[0] == 0)
+            break;
+
+        result.best_move = state.pv[0][0];
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(state.pv[0], state.pv[0] + state.pv_length[0]);
+
+        if(state.thread_id)
+            continue;
+
+        if(limits.print_info){
+            double elapsed = state.elapsed_ms();
+            unsigned long long nodes = state.total_nodes();
+            printf("info depth %d score %s %d nodes %llu time %.0f nps %.0f hashfull %d pv", depth,
+                   is_mate_score(score) ? "mate" : "cp", is_mate_score(score) ? mate_in_moves(score) : score, nodes,
+                   elapsed, nodes / std::max(elapsed, 1.0) * 1000, transposition_table.hashfull());
+            for(const Move &move : result.pv)
+                printf(" %s", move.to_uci().c_str());
+            printf("\n");
+        }
+
+        if(state.soft_limit > 0 && state.elapsed_ms() >= state.soft_limit)
+            break;
+    }
+}
+
+SearchResult search_best_move(Board &board, const SearchLimits &limits){
+    const int threads = std::clamp(limits.threads, 1, MAX_SEARCH_THREADS);
+    std::atomic<bool> stop = false;
+
+    // large (pv table, history) - kept off the stack
+    std::vector<std::unique_ptr<SearchState>> states;
+    for(int i = 0; i < threads; i++){
+        states.push_back(std::make_unique<SearchState>());
+        states[i]->thread_id = i;
+        states[i]->stop = &stop;
+        states[i]->ordering.clear();
+        states[i]->all_states = &states;
+    }
+
+    SearchState &state = *states[0];
+    state.start = std::chrono::steady_clock::now();
+    set_time_limits(state, limits, board.color_to_move);
+    for(auto &helper : states)
+        helper->start = state.start;
+
+    transposition_table.new_search();
+    init_lmr_reductions(search_params);
+
+    SearchResult result;
+
+    // root moves must be legal (no best move without them)
+    MoveList root_moves;
+    generate_legal_moves(board, root_moves);
+    if(root_moves.size() == 0)
+        return result;
+
+    result.best_move = root_moves[0];
+
+    std::vector<std::thread> helpers;
+    std::vector<Board> helper_boards;
+    std::vector<SearchResult> helper_results;
+    SplitPointPool pool;
+
+    if(limits.smp_mode == SmpMode::ybwc){
+        // helpers wait for split points of main thread's search
+        for(auto &helper : states)
+            helper->pool = threads > 1 ? &pool : nullptr;
+        for(int i = 1; i < threads; i++)
+            helpers.emplace_back(ybwc_helper, std::ref(*states[i]));
+    }
+    else{
+        // helpers search own board copies, sharing transposition table only
+        helper_boards.assign(threads - 1, board);
+        helper_results.resize(threads - 1);
+        for(int i = 1; i < threads; i++)
+            helpers.emplace_back(iterative_deepening, std::ref(*states[i]), std::ref(helper_boards[i - 1]),
+                                 std::cref(limits), std::ref(helper_results[i - 1]));
+    }
+
+    iterative_deepening(state, board, limits, result);
+
+    stop.store(true, std::memory_order_relaxed);
+    pool.changed.notify_all();
+    for(std::thread &helper : helpers)
+        helper.join();
+
+    result.nodes = state.total_nodes();
+    for(auto &helper : states){
+        result.beta_cutoffs += helper->beta_cutoffs;
+        result.first_move_cutoffs += helper->first_move_cutoffs;
+    }
+    result.seconds = state.elapsed_ms() / 1000;
+
+    return result;
+}
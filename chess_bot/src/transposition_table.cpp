@@ -0,0 +1,129 @@
+#include <algorithm>
+
+#include "transposition_table.hpp"
+
+// data word layout
+// | bits 0-19 move | 20-35 score (int16) | 36-43 depth | 44-45 bound | 46-51 age |
+constexpr int AGE_BITS = 6;
+constexpr int AGE_MASK = (1 << AGE_BITS) - 1;
+
+inline U64 pack_data(Move move, int score, int depth, Bound bound, int age){
+    return (U64)(move.encoded_value & 0xfffff) |
+           ((U64)(uint16_t)(int16_t)score << 20) |
+           ((U64)(depth & 0xff) << 36) |
+           ((U64)bound << 44) |
+           ((U64)(age & AGE_MASK) << 46);
+}
+
+inline int data_depth(U64 data){ return (data >> 36) & 0xff; }
+inline Bound data_bound(U64 data){ return static_cast<Bound>((data >> 44) & 0b11); }
+inline int data_age(U64 data){ return (data >> 46) & AGE_MASK; }
+
+TranspositionTable::TranspositionTable(size_t size_mb){
+    resize(size_mb);
+}
+
+void TranspositionTable::resize(size_t size_mb){
+    buckets.clear();
+    buckets.shrink_to_fit();
+    bucket_mask = 0;
+
+    if(size_mb == 0)
+        return;
+
+    // largest power of two number of buckets that fits in size_mb
+    size_t bytes = size_mb * 1024 * 1024;
+    size_t buckets_count = 1;
+    while(buckets_count * 2 * sizeof(TTBucket) <= bytes)
+        buckets_count *= 2;
+
+    buckets = std::vector<TTBucket>(buckets_count);
+    bucket_mask = buckets_count - 1;
+}
+
+void TranspositionTable::clear(){
+    for(TTBucket &bucket : buckets){
+        for(TTEntry &entry : bucket.entries){
+            entry.key_xor_data.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age = 0;
+}
+
+void TranspositionTable::new_search(){
+    age = (age + 1) & AGE_MASK;
+}
+
+bool TranspositionTable::probe(U64 key, TTData &tt_data) const{
+    if(buckets.empty())
+        return false;
+
+    const TTBucket &bucket = buckets[key & bucket_mask];
+    for(const TTEntry &entry : bucket.entries){
+        U64 data = entry.data.load(std::memory_order_relaxed);
+        if((entry.key_xor_data.load(std::memory_order_relaxed) ^ data) != key || data_bound(data) == Bound::none)
+            continue;
+
+        tt_data.move.encoded_value = data & 0xfffff;
+        tt_data.score = (int16_t)((data >> 20) & 0xffff);
+        tt_data.depth = data_depth(data);
+        tt_data.bound = data_bound(data);
+        return true;
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(U64 key, Move move, int score, int depth, Bound bound){
+    if(buckets.empty())
+        return;
+
+    TTBucket &bucket = buckets[key & bucket_mask];
+
+    // same position, else lowest depth (entries from older searches count as shallower)
+    TTEntry *replace = &bucket.entries[0];
+    int replace_value = 1 << 30;
+    for(TTEntry &entry : bucket.entries){
+        U64 data = entry.data.load(std::memory_order_relaxed);
+        if((entry.key_xor_data.load(std::memory_order_relaxed) ^ data) == key){
+            // much deeper non-exact result of same search stays
+            if(data_age(data) == age && bound != Bound::exact && depth + 2 < data_depth(data))
+                return;
+            if(move.encoded_value == 0)
+                move.encoded_value = data & 0xfffff;
+            replace = &entry;
+            break;
+        }
+
+        // empty entry first
+        int relative_age = (age - data_age(data)) & AGE_MASK;
+        int value = data_bound(data) == Bound::none ? -(1 << 30) : data_depth(data) - 8 * relative_age;
+        if(value < replace_value){
+            replace_value = value;
+            replace = &entry;
+        }
+    }
+
+    // score must fit in int16
+    score = std::clamp(score, -32767, 32767);
+
+    U64 data = pack_data(move, score, depth, bound, age);
+    replace->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const{
+    if(buckets.empty())
+        return 0;
+
+    int used = 0;
+    const size_t samples = std::min<size_t>(250, buckets.size());
+    for(size_t i = 0; i < samples; i++)
+        for(const TTEntry &entry : buckets[i].entries){
+            U64 data = entry.data.load(std::memory_order_relaxed);
+            used += data_bound(data) != Bound::none && data_age(data) == age;
+        }
+
+    return used * 1000 / (int)(samples * TT_BUCKET_SIZE);
+}
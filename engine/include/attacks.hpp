@@ -2,48 +2,418 @@
 
 #include <iostream>
 #include <cstdint>
+#include <array>
 
 
 #include "board.hpp"
+#include "constants.hpp"
 
 using U64 = uint64_t;
 
-extern U64 pawn_lookup_attacks[2][64];
+// ************************************
+// *     ATTACK CALCULATION
+// ************************************
+// constexpr - used to generate all lookup tables at compile time (attacks.cpp)
+// slow, don't use them in move generation
 
-extern U64 knight_lookup_attacks[64];
-extern U64 king_lookup_attacks[64];
+constexpr U64 calculate_bishop_attacks(int square, U64 occupancy){
+    U64 attacks = 0ULL;
 
-extern U64 rook_lookup_attacks[64][4096];
-extern U64 bishop_lookup_attacks[64][512];
+    // *up-right direction
+    U64 cursor = 1ULL << square;
+    // 46 is last interesting square
+    for(int sq = square; (sq / 8 < 7) & (sq % 8 < 7); sq+=9){
+        // move cursor
+        cursor <<= 9;
+        // save relevant square
+        attacks |= cursor;
 
-U64 calculate_bishop_attacks(int square, Board &game_state);
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
 
-U64 calculate_rook_attacks(int square, Board &game_state);
+    // *up-left direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 47 is last interesting square
+    for(int sq = square; (sq / 8 < 7) & (sq % 8 > 0); sq+=7){
+        // move cursor
+        cursor <<= 7;
 
-U64 rook_relevant_occupancy(int square);
+        // save relevant square
+        attacks |= cursor;
 
-U64 bishop_relevant_occupancy(int square);
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
 
-U64 pawn_attacks(int square, int color);
+    // *down-left direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 18 is first interesting square
+    for(int sq = square; (sq / 8 > 0) & (sq % 8 > 0); sq-=9){
+        // move cursor
+        cursor >>= 9;
 
-U64 king_attacks(int square);
+        // save relevant square
+        attacks |= cursor;
 
-U64 knight_attacks(int square);
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
 
-U64 rook_attacks(int square, Board &game_state);
+    // *down-right direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 21 is first interesting square
+    for(int sq = square; (sq / 8 > 0) & (sq % 8 < 7); sq-=7){
+        // move cursor
+        cursor >>= 7;
 
-U64 bishop_attacks(int square, Board &game_state);
+        // save relevant square
+        attacks |= cursor;
 
-U64 queen_attacks(int square, Board &game_state);
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
+    
+    return attacks;
+}
 
-void print_relevant_occupancy_count_tables();
+constexpr U64 calculate_rook_attacks(int square, U64 occupancy){
+    U64 attacks = 0ULL;
+    // * up
+    U64 cursor = 1ULL << square;
+    for(int sq = square; (sq / 8 < 7); sq+=8){
+        // move cursor
+        cursor <<= 8;
+
+        // save relevant square
+        attacks |= cursor;
+
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
+
+    // * down
+    // reset cursor
+    cursor = 1ULL << square;
+    for(int sq = square; (sq / 8 > 0); sq-=8){
+        // move cursor
+        cursor >>= 8;
+
+        // save relevant square
+        attacks |= cursor;
+
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
+
+    // * left
+    // reset cursor
+    cursor = 1ULL << square;
+    for(int sq = square; (sq % 8 > 0); sq-=1){
+        // move cursor
+        cursor >>= 1;
+
+        // save relevant square
+        attacks |= cursor;
+
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
+
+    // * right
+    // reset cursor
+    cursor = 1ULL << square;
+    for(int sq = square; (sq % 8 < 7); sq+=1){
+        // move cursor
+        cursor <<= 1;
+
+        // save relevant square
+        attacks |= cursor;
+
+        // blocker
+        if(cursor & occupancy)
+            break;
+    }
+
+    return attacks;
+}
+
+constexpr U64 rook_relevant_occupancy(int square){
+    int rank = square / 8;
+    int file = square % 8;
+    U64 border = RANK_1_MASK ^ RANK_8_MASK ^ A_FILE_MASK ^ H_FILE_MASK;
+    // border:
+    // 8   0 1 1 1 1 1 1 0   8
+    // 7   1 0 0 0 0 0 0 1   7
+    // 6   1 0 0 0 0 0 0 1   6
+    // 5   1 0 0 0 0 0 0 1   5
+    // 4   1 0 0 0 0 0 0 1   4
+    // 3   1 0 0 0 0 0 0 1   3
+    // 2   1 0 0 0 0 0 0 1   2
+    // 1   0 1 1 1 1 1 1 0   1
+
+    // if square on border:
+    if (rank == 0 || rank == 7){
+        border = border ^ RANK_MASK_ARR[rank];
+    }
+    if (file == 0 || file == 7){
+        border = border ^ FILE_MASK_ARR[file];
+    }
+    // XOR these edges (on square position); here square = a1
+    // 8   1 1 1 1 1 1 1 0   8
+    // 7   0 0 0 0 0 0 0 1   7
+    // 6   0 0 0 0 0 0 0 1   6
+    // 5   0 0 0 0 0 0 0 1   5
+    // 4   0 0 0 0 0 0 0 1   4
+    // 3   0 0 0 0 0 0 0 1   3
+    // 2   0 0 0 0 0 0 0 1   2
+    // 1   0 0 0 0 0 0 0 1   1
+
+    U64 relevant_occupancy = 
+    // make cross on square position (vertical and horizontal, actually '+' sign)
+    (RANK_MASK_ARR[rank] | FILE_MASK_ARR[file]) 
+    // remove border from relevant ocupancies
+    & ~(border) 
+    // remove square
+    & ~(1ULL << square);
+
+    return relevant_occupancy;
+}
+
+constexpr U64 bishop_relevant_occupancy(int square){
+    U64 relevant_occupancy = 0ULL;
+
+    // *up-right direction
+    U64 cursor = 1ULL << square;
+    // 46 is last interesting square
+    for(int sq = square; (sq / 8 < 6) & (sq % 8 < 6); sq+=9){
+        // move cursor
+        cursor <<= 9;
+
+        // save relevant square
+        relevant_occupancy |= cursor;
+    }
+
+    // *up-left direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 47 is last interesting square
+    for(int sq = square; (sq / 8 < 6) & (sq % 8 > 1); sq+=7){
+        // move cursor
+        cursor <<= 7;
+
+        // save relevant square
+        relevant_occupancy |= cursor;
+    }
+
+    // *down-left direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 18 is first interesting square
+    for(int sq = square; (sq / 8 > 1) & (sq % 8 > 1); sq-=9){
+        // move cursor
+        cursor >>= 9;
+
+        // save relevant square
+        relevant_occupancy |= cursor;
+    }
+
+    // *down-right direction
+    // reset cursor to square
+    cursor = 1ULL << square;
+    // 21 is first interesting square
+    for(int sq = square; (sq / 8 > 1) & (sq % 8 < 6); sq-=7){
+        // move cursor
+        cursor >>= 7;
+
+        // save relevant square
+        relevant_occupancy |= cursor;
+    }
+    
+    return relevant_occupancy;
+}
+
+constexpr U64 pawn_attacks(int square, int color){
+    U64 piece_position = 1Ull << square;
+    if(color == static_cast<int>(COLOR::white)){
+        // bit shift and mask overflowing bits
+        return ((piece_position << 9) & NOT_A_FILE) | ((piece_position << 7) & NOT_H_FILE);
+    }
+    
+    // bit shift and mask overflowing bits
+    return ((piece_position >> 7) & NOT_A_FILE) | ((piece_position >> 9) & NOT_H_FILE);
+}
 
-void init_rook_bishop_lookup_tables(bool rook, Board &game_state);
+constexpr U64 king_attacks(int square){
+    // left    right
+    // <<7 <<8 <<9
+    // >>1  K  <<1
+    // >>9 >>8 >>7
+    // left side moves mask with NOT_H_RANK
+    // right side moves mask with NOT_A_RANK
 
-void init_pawn_lookup_table();
+    U64 piece_position = 1Ull << square;
 
-void init_king_lookup_table();
+    U64 attacks =
+    // up
+    (piece_position << 8) |
+    //down
+    (piece_position >> 8) |
+    //right
+    (((piece_position << 9) | (piece_position << 1) | (piece_position >> 7)) & NOT_A_FILE) |
+    //left
+    (((piece_position << 7) | (piece_position >> 1) | (piece_position >> 9)) & NOT_H_FILE);
 
-void init_knight_lookup_table();
+    return attacks;
+}
+
+constexpr U64 knight_attacks(int square){
+    U64 piece_position = 1Ull << square;
+
+    //| GH |  H |   |  A | AB |
+    //|    |<<15| - |<<17|    |
+    //|<<6 |    | - |    |<<10|
+    //|    |    | N |    |    |
+    //|>>10|    | - |    |>>6 |
+    //|    |>>17| - |>>15|    |
+    // moves must be masked to prevent overflowing moves
+
+    U64 attacks =
+    // A mask
+    (((piece_position << 17) | (piece_position >> 15)) & NOT_A_FILE) |
+    // AB mask
+    (((piece_position << 10) | (piece_position >> 6)) & NOT_AB_FILE) |
+    // H mask
+    (((piece_position << 15) | (piece_position >> 17)) & NOT_H_FILE) |
+    // GH mask
+    (((piece_position << 6) | (piece_position >> 10)) & NOT_GH_FILE);
+
+    return attacks;
+    
+}
+
+// ************************************
+// *       LOOKUP TABLES
+// ************************************
+// generated at compile time (constinit in attacks.cpp) - they live in read-only data,
+// no initialization at startup and pages are shared between processes
+
+extern const std::array<std::array<U64, 64>, 2> pawn_lookup_attacks;
+
+extern const std::array<U64, 64> knight_lookup_attacks;
+extern const std::array<U64, 64> king_lookup_attacks;
+
+// "fancy" magic layout - one contiguous buffer per slider,
+// square entries are packed one after another (2^relevant_bits attacks per square)
+// instead of worst-case [64][4096] / [64][512] padding
+constexpr int ROOK_ATTACK_TABLE_SIZE = 102400;
+constexpr int BISHOP_ATTACK_TABLE_SIZE = 5248;
+
+extern const std::array<U64, ROOK_ATTACK_TABLE_SIZE> rook_attack_table;
+extern const std::array<U64, BISHOP_ATTACK_TABLE_SIZE> bishop_attack_table;
+
+#ifdef ENGINE_PEXT
+// same layout, indexed with pext (generated without magic numbers)
+extern const std::array<U64, ROOK_ATTACK_TABLE_SIZE> rook_pext_attack_table;
+extern const std::array<U64, BISHOP_ATTACK_TABLE_SIZE> bishop_pext_attack_table;
+#endif
+
+// magic bitboard entry - everything needed for one slider lookup on one square
+// index = ((occupancy & mask) * magic) >> shift
+struct MagicEntry{
+    // relevant occupancy mask (without board edges and square itself)
+    U64 mask = 0ULL;
+    U64 magic = 0ULL;
+    // 64 - relevant occupancy bits count
+    int shift = 0;
+    // attacks for this square (points into shared attack table)
+    const U64 *attacks = nullptr;
+#ifdef ENGINE_PEXT
+    // attacks for this square indexed with pext
+    const U64 *pext_attacks = nullptr;
+#endif
+};
+
+extern const std::array<MagicEntry, 64> rook_magic_table;
+extern const std::array<MagicEntry, 64> bishop_magic_table;
+
+// how slider attack tables are indexed
+// magic - ((occupancy & mask) * magic) >> shift, works on every CPU
+// pext  - BMI2 parallel bit extract of occupancy under mask (build option ENGINE_PEXT)
+enum class SliderBackend{
+    magic,
+    pext
+};
+
+extern SliderBackend slider_backend;
+
+#ifdef ENGINE_PEXT
+// pext through inline asm, so the engine doesn't have to be compiled with -mbmi2
+// (instruction is executed only after runtime CPUID check)
+inline U64 pext(U64 source, U64 mask){
+    U64 result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(source), "rm"(mask));
+    return result;
+}
+#endif
+
+// true if built with ENGINE_PEXT and CPU has fast (not microcoded) pext
+bool pext_supported();
+
+// switch backend (both tables are always present)
+// returns false if backend is not available on this build / CPU
+bool set_slider_backend(SliderBackend backend);
+
+const char *slider_backend_name(SliderBackend backend);
+
+// magic: one AND, one multiply, one shift and one load per lookup; pext: one pext and one load
+// ENGINE_PEXT builds pick backend at runtime - every lookup branches on slider_backend
+// (fixed for whole run, so branch is always predicted)
+inline U64 slider_attacks(const MagicEntry &entry, U64 occupancy){
+#ifdef ENGINE_PEXT
+    if(slider_backend == SliderBackend::pext)
+        return entry.pext_attacks[pext(occupancy, entry.mask)];
+#endif
+    return entry.attacks[((occupancy & entry.mask) * entry.magic) >> entry.shift];
+}
+
+inline U64 rook_attacks(int square, U64 occupancy){
+    return slider_attacks(rook_magic_table[square], occupancy);
+}
+
+inline U64 bishop_attacks(int square, U64 occupancy){
+    return slider_attacks(bishop_magic_table[square], occupancy);
+}
+
+inline U64 rook_attacks(int square, Board &game_state){
+    return rook_attacks(square, game_state.both_occupancy_bitboard);
+}
+
+inline U64 bishop_attacks(int square, Board &game_state){
+    return bishop_attacks(square, game_state.both_occupancy_bitboard);
+}
+
+inline U64 queen_attacks(int square, Board &game_state){
+    return (bishop_attacks(square, game_state) | rook_attacks(square, game_state));
+}
+
+// squares strictly between two squares on the same rank, file or diagonal (0 otherwise)
+extern const std::array<std::array<U64, 64>, 64> between_squares;
+// whole line (edge to edge) through two squares on the same rank, file or diagonal (0 otherwise)
+extern const std::array<std::array<U64, 64>, 64> line_through_squares;
+
+void print_relevant_occupancy_count_tables();
 
-void init_all_lookup_tables(Board &game_state);
\ No newline at end of file
+// tables are generated at compile time
+// only chooses fastest slider backend for this CPU
+void init_all_lookup_tables();
\ No newline at end of file
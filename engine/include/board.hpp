@@ -4,14 +4,39 @@
 #include <vector>
 #include <array>
 #include <cstdint>
+#include <bit>
 
 
 #include "enums.hpp"
+#include "zobrist.hpp"
+#include "psqt.hpp"
 
 
 using U64 = uint64_t;
 
+// empty square in Board mailbox (PIECE enum goes 0..11)
+constexpr uint8_t NO_PIECE = 12;
+
+// irreversible state saved by make_move and restored by unmake_move
+struct Undo{
+    // encoded Move (needed when popping Board history)
+    unsigned int move = 0;
+    // PIECE enum; NO_PIECE none
+    uint8_t captured_piece = NO_PIECE;
+    uint8_t castles = 0;
+    int8_t en_passant_square = -1;
+    uint16_t halfmove_counter = 0;
+    // position key before the move (also used for repetition detection)
+    U64 hash_key = 0ULL;
+};
+
 class Board{
+    static constexpr std::array<uint8_t, 64> filled_mailbox(){
+        std::array<uint8_t, 64> empty{};
+        empty.fill(NO_PIECE);
+        return empty;
+    }
+
 public:
     // bitboards; index: PIECE enum
     U64 bitboards[12] = {0ULL};
@@ -20,6 +45,9 @@ public:
     U64 color_occupancy_bitboards[2] = {0ULL};
     U64 both_occupancy_bitboard = 0ULL;
 
+    // mailbox - piece on every square (PIECE enum | NO_PIECE), kept in sync with bitboards
+    std::array<uint8_t, 64> mailbox = filled_mailbox();
+
     // castle system - each bit describes one possibility
     // | white queenside | white kingside | black queenside | black kingside |
     // |      bit 0/1    |     bit 0/1    |     bit 0/1     |    bit 0/1     |
@@ -37,12 +65,86 @@ public:
     // Fullmove number: The number of the full moves. It starts at 1 and is incremented after Black's move.
     int fullmove_number = 1;
 
+    // zobrist keys, updated incrementally by make_move
+    // full position
+    U64 hash_key = 0ULL;
+    // pawns of both colors only
+    U64 pawn_key = 0ULL;
+    // piece counts only
+    U64 material_key = 0ULL;
+
+    // material + piece-square score (white positive), updated incrementally with pieces
+    int psqt_score = 0;
+
+    // position history stack (push_move / pop_move) - search walks the tree in place
+    // kept out of Board's own storage: copies of fresh positions stay small
+    std::vector<Undo> history;
+
+    Board() = default;
+    Board(const Board &other) = default;
+
     // przeciążenie operatora przypisania
     Board &operator=(const Board &other);
 
+    inline void put_piece(int piece, int square){
+        U64 square_bitboard = 1ULL << square;
+        bitboards[piece] |= square_bitboard;
+        color_occupancy_bitboards[piece / 6] |= square_bitboard;
+        both_occupancy_bitboard |= square_bitboard;
+        mailbox[square] = piece;
+        psqt_score += piece_square_scores[piece][square];
+
+        hash_key ^= zobrist_piece_keys[piece][square];
+        material_key ^= zobrist_piece_keys[piece][std::popcount(bitboards[piece]) - 1];
+        if (piece % 6 == static_cast<int>(PIECE::P))
+            pawn_key ^= zobrist_piece_keys[piece][square];
+    }
+
+    inline void remove_piece(int piece, int square){
+        U64 square_bitboard = 1ULL << square;
+        bitboards[piece] &= ~square_bitboard;
+        color_occupancy_bitboards[piece / 6] &= ~square_bitboard;
+        both_occupancy_bitboard &= ~square_bitboard;
+        mailbox[square] = NO_PIECE;
+        psqt_score -= piece_square_scores[piece][square];
+
+        hash_key ^= zobrist_piece_keys[piece][square];
+        material_key ^= zobrist_piece_keys[piece][std::popcount(bitboards[piece])];
+        if (piece % 6 == static_cast<int>(PIECE::P))
+            pawn_key ^= zobrist_piece_keys[piece][square];
+    }
+
+    inline void move_piece(int piece, int from_square, int to_square){
+        U64 from_to_bitboard = (1ULL << from_square) | (1ULL << to_square);
+        bitboards[piece] ^= from_to_bitboard;
+        color_occupancy_bitboards[piece / 6] ^= from_to_bitboard;
+        both_occupancy_bitboard ^= from_to_bitboard;
+        mailbox[from_square] = NO_PIECE;
+        mailbox[to_square] = piece;
+        psqt_score += piece_square_scores[piece][to_square] - piece_square_scores[piece][from_square];
+
+        U64 from_to_key = zobrist_piece_keys[piece][from_square] ^ zobrist_piece_keys[piece][to_square];
+        hash_key ^= from_to_key;
+        if (piece % 6 == static_cast<int>(PIECE::P))
+            pawn_key ^= from_to_key;
+    }
+
+    // PIECE enum on square | NO_PIECE
+    inline int piece_on_square(int square) const{
+        return mailbox[square];
+    }
+
+    // zobrist keys computed from scratch (load_fen, debug cross-check)
+    U64 compute_hash_key() const;
+    U64 compute_pawn_key() const;
+    U64 compute_material_key() const;
+    // psqt_score computed from scratch
+    int compute_psqt_score() const;
+
     void clear_bitboards();
 
     void load_fen(std::string fen);
+    std::string get_fen() const;
 
     void print_game_state();
     void print_board_unicode();
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <vector>
+#include <string>
 
 #include "board.hpp"
 
@@ -28,20 +29,119 @@ public:
     void encode_move(int from_square, int to_square, int piece, MoveType move_type);
 
     void print() const;
+
+    // long algebraic notation (e2e4, e7e8q)
+    std::string to_uci() const;
+};
+
+// promotion move type & 0b11 -> promoted piece (knight, bishop, rook, queen)
+inline constexpr int promotion_piece[4] = {
+    static_cast<int>(PIECE::N), static_cast<int>(PIECE::B), static_cast<int>(PIECE::R), static_cast<int>(PIECE::Q)
+};
+
+// max number of moves in any chess position is 218
+constexpr int MAX_MOVES = 256;
+
+// fixed capacity move list living on the stack - generating moves doesn't allocate
+class MoveList{
+public:
+    // storage is left uninitialized (no zeroing of 256 moves at every node)
+    union{
+        Move moves[MAX_MOVES];
+    };
+    int count = 0;
+
+    MoveList() {}
+
+    inline void push_back(Move move){
+        moves[count++] = move;
+    }
+
+    inline int size() const{
+        return count;
+    }
+
+    inline void clear(){
+        count = 0;
+    }
+
+    inline Move &operator[](int index){
+        return moves[index];
+    }
+
+    inline const Move &operator[](int index) const{
+        return moves[index];
+    }
+
+    inline Move *begin(){ return moves; }
+    inline Move *end(){ return moves + count; }
+    inline const Move *begin() const{ return moves; }
+    inline const Move *end() const{ return moves + count; }
 };
 
 bool is_square_attacked_by(int square, int side, Board &game_state);
 // debug / testing
 U64 get_attacked_squares(int side, Board &game_state);
 
+// squares attacked by <side> pieces with given occupancy (set-wise)
+U64 get_attacked_squares_mask(int side, U64 occupancy, Board &game_state);
+
+// which pseudo-legal moves are generated
+enum class GenType{
+    all,
+    // captures (with en passant and capture promotions) and queen promotions - no quiet moves
+    captures,
+    // everything else (all = captures + quiets)
+    quiets
+};
+
+// pseudo-legal moves, appended to caller-owned list
+void generate_moves(Board &game_state, MoveList &moves, GenType gen_type = GenType::all);
 std::vector<Move> generate_moves(Board &game_state);
 
+// could move be generated in this position (killer / hash move from other position)
+bool is_pseudo_legal(const Move &move, Board &board);
+
 // makes move on given board
-// returns 1 if legal; 0 if not legal
+// irreversible state is saved to undo (needed by unmake_move)
+void make_move(Move move, Board &board, Undo &undo);
 void make_move(Move move, Board &board);
 
+// takes back move made with make_move
+void unmake_move(Move move, const Undo &undo, Board &board);
+
+// passes turn (null move pruning); undo.move is 0
+void make_null_move(Board &board, Undo &undo);
+void unmake_null_move(const Undo &undo, Board &board);
+
+// make / unmake using board history stack
+void push_move(Move move, Board &board);
+void pop_move(Board &board);
+void push_null_move(Board &board);
+void pop_null_move(Board &board);
+
+// make/unmake legality check of pseudo-legal move (slow, reference for validation)
+bool isMoveLegal(const Move &move, Board &board);
+
+// legal moves (pin / check masks, no copy-make), appended to caller-owned list
+void generate_legal_moves(Board &game_state, MoveList &moves);
 std::vector<Move> generate_legal_moves(Board &game_state);
 
+// side to move checks against enemy king, computed once per position
+struct CheckInfo{
+    // enemy king
+    int king_square = 0;
+    // index: piece type (PIECE::P..K) - squares from which that piece attacks enemy king
+    U64 check_squares[6] = {0ULL};
+    // our pieces that are the only blocker between our slider and enemy king
+    U64 discovered_check_candidates = 0ULL;
+};
+
+void compute_check_info(Board &board, CheckInfo &check_info);
+
+// does legal move give check (without making it; en passant and castles are made and taken back)
+bool gives_check(const Move &move, Board &board, const CheckInfo &check_info);
+
 // bool isKingUnderAttack(Board &board);
 bool isKingUnderAttack(Board &board, bool other_side = false);
 
@@ -1,5 +1,7 @@
 #pragma once
 #include <iostream>
+#include <vector>
+#include <atomic>
 
 #include "enums.hpp"
 #include "moves.hpp"
@@ -13,8 +15,75 @@ struct PerftMovesCount
     unsigned long long checkmates = 0;
     unsigned long long castles = 0;
     unsigned long long promotion = 0;
+
+    PerftMovesCount &operator+=(const PerftMovesCount &other){
+        count += other.count;
+        captures += other.captures;
+        en_pasants += other.en_pasants;
+        checks += other.checks;
+        checkmates += other.checkmates;
+        castles += other.castles;
+        promotion += other.promotion;
+        return *this;
+    }
+
+    bool operator==(const PerftMovesCount &other) const = default;
+};
+
+// check word, depth, 7 counters
+constexpr int PERFT_ENTRY_WORDS = 9;
+
+struct PerftTableEntry{
+    std::atomic<U64> words[PERFT_ENTRY_WORDS] = {};
+};
+
+// (zobrist key, depth) -> PerftMovesCount
+// lockless (XOR check word), power of two number of entries, always replace
+class PerftTable{
+public:
+    explicit PerftTable(size_t size_mb);
+
+    void resize(size_t size_mb);
+    void clear();
+
+    bool probe(U64 key, int depth, PerftMovesCount &counts) const;
+    void store(U64 key, int depth, const PerftMovesCount &counts);
+
+    inline size_t size() const{ return entries.size(); }
+
+private:
+    std::vector<PerftTableEntry> entries;
+    size_t index_mask = 0;
+
+    size_t index(U64 key, int depth) const;
 };
 
 void printPerftObject(PerftMovesCount obj);
 
-PerftMovesCount perf(int depth, Board &board);
\ No newline at end of file
+// shallower nodes are not probed / stored - depth 1 is cheaper to recount than to hash,
+// and its entries (most nodes of tree) would evict deeper ones
+constexpr int PERFT_HASH_MIN_DEPTH = 2;
+
+// detailed perft: captures, en passant, castles, promotions, checks, checkmates
+// table is optional - results are identical with and without it
+PerftMovesCount perf(int depth, Board &board, PerftTable *table = nullptr);
+
+// count-only entries are kept in table under depth + offset (don't mix with detailed entries)
+constexpr int PERFT_COUNT_ONLY_DEPTH = 128;
+
+// count-only perft (raw generator throughput) - leaf moves are counted, not made
+unsigned long long perft_count(int depth, Board &board, PerftTable *table = nullptr);
+
+enum class PerftMode{
+    count_only,
+    detailed
+};
+// max ply at which parallel perft splits the tree into work items
+constexpr int MAX_PERFT_SPLIT_PLY = 4;
+
+// perft split into work items (positions split_ply plies from root: 1 = root moves),
+// items are distributed over threads_count threads with work stealing
+// results are identical to perf()
+// count_only mode fills only count
+PerftMovesCount parallel_perf(int depth, Board &board, int threads_count, int split_ply = 1, PerftTable *table = nullptr,
+                              PerftMode mode = PerftMode::detailed);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <array>
+
+// ************************************
+// *     MATERIAL + PIECE-SQUARE SCORE
+// ************************************
+// PIECE_VALUE + piece-square bonus of every piece on every square (pieces_weights.hpp),
+// white pieces positive, black negative - Board sums it incrementally (Board::psqt_score)
+
+// index: [PIECE enum][square]
+extern const std::array<std::array<int, 64>, 12> piece_square_scores;
@@ -16,6 +16,6 @@ inline void pop_bit(U64 &bitboard){
 // get least significant bit set(1)
 // return index of that bit (0x1 => 0, 0x1000 => 3)
 // more precise: number of zeros before FS1B
-inline int get_LS1B(U64 &bitboard){
+inline int get_LS1B(const U64 &bitboard){
     return std::countr_zero(bitboard);
 }
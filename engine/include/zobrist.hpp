@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+using U64 = uint64_t;
+
+// ************************************
+// *        ZOBRIST HASHING
+// ************************************
+// random keys generated at compile time (fixed seed - same keys in every build)
+// position key = XOR of keys of: pieces on squares, side to move, castle rights, en passant file
+
+// index: [PIECE enum][square]
+// material key uses same table with index [PIECE enum][piece count]
+extern const std::array<std::array<U64, 64>, 12> zobrist_piece_keys;
+// index: Board::castles (4 bits)
+extern const std::array<U64, 16> zobrist_castle_keys;
+// index: file of en passant square
+extern const std::array<U64, 8> zobrist_en_passant_keys;
+// XORed in when black to move
+extern const U64 zobrist_side_key;
+
+// xorshift64* step
+constexpr U64 zobrist_random(U64 &state){
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
@@ -1,326 +1,176 @@
 #include <iostream>
 #include <random>
+#include <cstring>
+
+#ifdef ENGINE_PEXT
+#include <cpuid.h>
+#endif
 
 #include "attacks.hpp"
 #include "constants.hpp"
-#include "attacks.hpp"
 #include "utility.hpp"
 
 using U64 = uint64_t;
 
-U64 pawn_lookup_attacks[2][64];
-
-U64 knight_lookup_attacks[64];
-U64 king_lookup_attacks[64];
-
-U64 rook_lookup_attacks[64][4096];
-U64 bishop_lookup_attacks[64][512];
-
-U64 calculate_bishop_attacks(int square, Board &game_state){
-    U64 attacks = 0ULL;
-
-    // *up-right direction
-    U64 cursor = 1ULL << square;
-    // 46 is last interesting square
-    for(int sq = square; (sq / 8 < 7) & (sq % 8 < 7); sq+=9){
-        // move cursor
-        cursor <<= 9;
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
-    }
-
-    // *up-left direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 47 is last interesting square
-    for(int sq = square; (sq / 8 < 7) & (sq % 8 > 0); sq+=7){
-        // move cursor
-        cursor <<= 7;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
-    }
-
-    // *down-left direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 18 is first interesting square
-    for(int sq = square; (sq / 8 > 0) & (sq % 8 > 0); sq-=9){
-        // move cursor
-        cursor >>= 9;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
-    }
-
-    // *down-right direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 21 is first interesting square
-    for(int sq = square; (sq / 8 > 0) & (sq % 8 < 7); sq-=7){
-        // move cursor
-        cursor >>= 7;
-
-        // save relevant square
-        attacks |= cursor;
+// ************************************
+// *   COMPILE TIME TABLE GENERATION
+// ************************************
 
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
+constexpr std::array<std::array<U64, 64>, 2> generate_pawn_lookup_table(){
+    std::array<std::array<U64, 64>, 2> table{};
+    for(int side = 0; side < 2; side++){
+        for (int square = 0; square < 64; square++){
+            table[side][square] = pawn_attacks(square, side);
+        }
     }
-    
-    return attacks;
+    return table;
 }
 
-U64 calculate_rook_attacks(int square, Board &game_state){
-    U64 attacks = 0ULL;
-    // * up
-    U64 cursor = 1ULL << square;
-    for(int sq = square; (sq / 8 < 7); sq+=8){
-        // move cursor
-        cursor <<= 8;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
-    }
-
-    // * down
-    // reset cursor
-    cursor = 1ULL << square;
-    for(int sq = square; (sq / 8 > 0); sq-=8){
-        // move cursor
-        cursor >>= 8;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
-    }
-
-    // * left
-    // reset cursor
-    cursor = 1ULL << square;
-    for(int sq = square; (sq % 8 > 0); sq-=1){
-        // move cursor
-        cursor >>= 1;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
+constexpr std::array<U64, 64> generate_king_lookup_table(){
+    std::array<U64, 64> table{};
+    for (int square = 0; square < 64; square++){
+        table[square] = king_attacks(square);
     }
+    return table;
+}
 
-    // * right
-    // reset cursor
-    cursor = 1ULL << square;
-    for(int sq = square; (sq % 8 < 7); sq+=1){
-        // move cursor
-        cursor <<= 1;
-
-        // save relevant square
-        attacks |= cursor;
-
-        // blocker
-        if(cursor & game_state.both_occupancy_bitboard)
-            break;
+constexpr std::array<U64, 64> generate_knight_lookup_table(){
+    std::array<U64, 64> table{};
+    for (int square = 0; square < 64; square++){
+        table[square] = knight_attacks(square);
     }
-
-    return attacks;
+    return table;
 }
 
-U64 rook_relevant_occupancy(int square){
-    int rank = square / 8;
-    int file = square % 8;
-    U64 border = RANK_1_MASK ^ RANK_8_MASK ^ A_FILE_MASK ^ H_FILE_MASK;
-    // border:
-    // 8   0 1 1 1 1 1 1 0   8
-    // 7   1 0 0 0 0 0 0 1   7
-    // 6   1 0 0 0 0 0 0 1   6
-    // 5   1 0 0 0 0 0 0 1   5
-    // 4   1 0 0 0 0 0 0 1   4
-    // 3   1 0 0 0 0 0 0 1   3
-    // 2   1 0 0 0 0 0 0 1   2
-    // 1   0 1 1 1 1 1 1 0   1
-
-    // if square on border:
-    if (rank == 0 || rank == 7){
-        border = border ^ RANK_MASK_ARR[rank];
-    }
-    if (file == 0 || file == 7){
-        border = border ^ FILE_MASK_ARR[file];
+// size of packed slider table: sum of 2^relevant_bits over all squares
+constexpr int slider_attack_table_size(bool rook){
+    int size = 0;
+    for(int square = 0; square < 64; square++){
+        size += 1 << (rook ? rook_relevant_occupancy_count[square] : bishop_relevant_occupancy_count[square]);
     }
-    // XOR these edges (on square position); here square = a1
-    // 8   1 1 1 1 1 1 1 0   8
-    // 7   0 0 0 0 0 0 0 1   7
-    // 6   0 0 0 0 0 0 0 1   6
-    // 5   0 0 0 0 0 0 0 1   5
-    // 4   0 0 0 0 0 0 0 1   4
-    // 3   0 0 0 0 0 0 0 1   3
-    // 2   0 0 0 0 0 0 0 1   2
-    // 1   0 0 0 0 0 0 0 1   1
-
-    U64 relevant_occupancy = 
-    // make cross on square position (vertical and horizontal, actually '+' sign)
-    (RANK_MASK_ARR[rank] | FILE_MASK_ARR[file]) 
-    // remove border from relevant ocupancies
-    & ~(border) 
-    // remove square
-    & ~(1ULL << square);
-
-    return relevant_occupancy;
+    return size;
 }
 
-U64 bishop_relevant_occupancy(int square){
-    U64 relevant_occupancy = 0ULL;
+static_assert(slider_attack_table_size(true) == ROOK_ATTACK_TABLE_SIZE);
+static_assert(slider_attack_table_size(false) == BISHOP_ATTACK_TABLE_SIZE);
 
-    // *up-right direction
-    U64 cursor = 1ULL << square;
-    // 46 is last interesting square
-    for(int sq = square; (sq / 8 < 6) & (sq % 8 < 6); sq+=9){
-        // move cursor
-        cursor <<= 9;
+template<int SIZE>
+constexpr std::array<U64, SIZE> generate_slider_attack_table(bool rook, SliderBackend backend){
+    std::array<U64, SIZE> table{};
+    // offset of current square in packed attack table
+    int offset = 0;
 
-        // save relevant square
-        relevant_occupancy |= cursor;
+    for(int square = 0; square < 64; square++){
+        U64 mask = rook ? rook_relevant_occupancy(square) : bishop_relevant_occupancy(square);
+        U64 magic = rook ? rook_magic_numbers[square] : bishop_magic_numbers[square];
+        int relevant_bits = rook ? rook_relevant_occupancy_count[square] : bishop_relevant_occupancy_count[square];
+
+        // iterate over all subsets of mask (carry-rippler)
+        // starts with empty occupancy and ends when it comes back to 0
+        // subsets come in increasing pext order, so pext index is just the variation number
+        U64 relevant_occupancy = 0ULL;
+        int variation = 0;
+        do{
+            int index = (backend == SliderBackend::pext) ?
+            variation :
+            (relevant_occupancy * magic) >> (64 - relevant_bits);
+
+            table[offset + index] = rook ? calculate_rook_attacks(square, relevant_occupancy) : calculate_bishop_attacks(square, relevant_occupancy);
+
+            relevant_occupancy = (relevant_occupancy - mask) & mask;
+            variation++;
+        } while(relevant_occupancy);
+
+        offset += 1 << relevant_bits;
     }
 
-    // *up-left direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 47 is last interesting square
-    for(int sq = square; (sq / 8 < 6) & (sq % 8 > 1); sq+=7){
-        // move cursor
-        cursor <<= 7;
-
-        // save relevant square
-        relevant_occupancy |= cursor;
-    }
+    return table;
+}
 
-    // *down-left direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 18 is first interesting square
-    for(int sq = square; (sq / 8 > 1) & (sq % 8 > 1); sq-=9){
-        // move cursor
-        cursor >>= 9;
+constexpr std::array<MagicEntry, 64> generate_magic_entries(bool rook, const U64 *attacks, [[maybe_unused]] const U64 *pext_attacks){
+    std::array<MagicEntry, 64> entries{};
+    int offset = 0;
 
-        // save relevant square
-        relevant_occupancy |= cursor;
+    for(int square = 0; square < 64; square++){
+        MagicEntry &entry = entries[square];
+        entry.mask = rook ? rook_relevant_occupancy(square) : bishop_relevant_occupancy(square);
+        entry.magic = rook ? rook_magic_numbers[square] : bishop_magic_numbers[square];
+        entry.shift = 64 - (rook ? rook_relevant_occupancy_count[square] : bishop_relevant_occupancy_count[square]);
+        entry.attacks = attacks + offset;
+#ifdef ENGINE_PEXT
+        entry.pext_attacks = pext_attacks + offset;
+#endif
+        offset += 1 << (64 - entry.shift);
     }
 
-    // *down-right direction
-    // reset cursor to square
-    cursor = 1ULL << square;
-    // 21 is first interesting square
-    for(int sq = square; (sq / 8 > 1) & (sq % 8 < 6); sq-=7){
-        // move cursor
-        cursor >>= 7;
+    return entries;
+}
 
-        // save relevant square
-        relevant_occupancy |= cursor;
+constexpr std::array<std::array<U64, 64>, 64> generate_between_squares(){
+    std::array<std::array<U64, 64>, 64> table{};
+    for(int a = 0; a < 64; a++){
+        for(int b = 0; b < 64; b++){
+            U64 a_bb = 1ULL << a;
+            U64 b_bb = 1ULL << b;
+
+            // b visible from a on empty board - intersect rays blocked by each other
+            if(calculate_rook_attacks(a, 0ULL) & b_bb)
+                table[a][b] = calculate_rook_attacks(a, b_bb) & calculate_rook_attacks(b, a_bb);
+            else if(calculate_bishop_attacks(a, 0ULL) & b_bb)
+                table[a][b] = calculate_bishop_attacks(a, b_bb) & calculate_bishop_attacks(b, a_bb);
+        }
     }
-    
-    return relevant_occupancy;
+    return table;
 }
 
-U64 pawn_attacks(int square, int color){
-    U64 piece_position = 1Ull << square;
-    if(color == static_cast<int>(COLOR::white)){
-        // bit shift and mask overflowing bits
-        return ((piece_position << 9) & NOT_A_FILE) | ((piece_position << 7) & NOT_H_FILE);
+constexpr std::array<std::array<U64, 64>, 64> generate_line_through_squares(){
+    std::array<std::array<U64, 64>, 64> table{};
+    for(int a = 0; a < 64; a++){
+        for(int b = 0; b < 64; b++){
+            U64 a_bb = 1ULL << a;
+            U64 b_bb = 1ULL << b;
+
+            // empty board rays of both squares share the line they are on
+            if(calculate_rook_attacks(a, 0ULL) & b_bb)
+                table[a][b] = (calculate_rook_attacks(a, 0ULL) & calculate_rook_attacks(b, 0ULL)) | a_bb | b_bb;
+            else if(calculate_bishop_attacks(a, 0ULL) & b_bb)
+                table[a][b] = (calculate_bishop_attacks(a, 0ULL) & calculate_bishop_attacks(b, 0ULL)) | a_bb | b_bb;
+        }
     }
-    
-    // bit shift and mask overflowing bits
-    return ((piece_position >> 7) & NOT_A_FILE) | ((piece_position >> 9) & NOT_H_FILE);
+    return table;
 }
 
-U64 king_attacks(int square){
-    // left    right
-    // <<7 <<8 <<9
-    // >>1  K  <<1
-    // >>9 >>8 >>7
-    // left side moves mask with NOT_H_RANK
-    // right side moves mask with NOT_A_RANK
-
-    U64 piece_position = 1Ull << square;
-
-    U64 attacks =
-    // up
-    (piece_position << 8) |
-    //down
-    (piece_position >> 8) |
-    //right
-    (((piece_position << 9) | (piece_position << 1) | (piece_position >> 7)) & NOT_A_FILE) |
-    //left
-    (((piece_position << 7) | (piece_position >> 1) | (piece_position >> 9)) & NOT_H_FILE);
-
-    return attacks;
-}
+constinit const std::array<std::array<U64, 64>, 2> pawn_lookup_attacks = generate_pawn_lookup_table();
 
-U64 knight_attacks(int square){
-    U64 piece_position = 1Ull << square;
-
-    //| GH |  H |   |  A | AB |
-    //|    |<<15| - |<<17|    |
-    //|<<6 |    | - |    |<<10|
-    //|    |    | N |    |    |
-    //|>>10|    | - |    |>>6 |
-    //|    |>>17| - |>>15|    |
-    // moves must be masked to prevent overflowing moves
-
-    U64 attacks =
-    // A mask
-    (((piece_position << 17) | (piece_position >> 15)) & NOT_A_FILE) |
-    // AB mask
-    (((piece_position << 10) | (piece_position >> 6)) & NOT_AB_FILE) |
-    // H mask
-    (((piece_position << 15) | (piece_position >> 17)) & NOT_H_FILE) |
-    // GH mask
-    (((piece_position << 6) | (piece_position >> 10)) & NOT_GH_FILE);
-
-    return attacks;
-    
-}
+constinit const std::array<U64, 64> knight_lookup_attacks = generate_knight_lookup_table();
+constinit const std::array<U64, 64> king_lookup_attacks = generate_king_lookup_table();
 
-U64 rook_attacks(int square, Board &game_state){
-    U64 magic_number = rook_magic_numbers[square];
-    U64 relevant_occupancy = rook_relevant_occupancy(square) & game_state.both_occupancy_bitboard;
-    int magic_index = relevant_occupancy * magic_number >> (64-rook_relevant_occupancy_count[square]);
+constinit const std::array<U64, ROOK_ATTACK_TABLE_SIZE> rook_attack_table =
+    generate_slider_attack_table<ROOK_ATTACK_TABLE_SIZE>(true, SliderBackend::magic);
+constinit const std::array<U64, BISHOP_ATTACK_TABLE_SIZE> bishop_attack_table =
+    generate_slider_attack_table<BISHOP_ATTACK_TABLE_SIZE>(false, SliderBackend::magic);
 
-    return rook_lookup_attacks[square][magic_index];
-}
+#ifdef ENGINE_PEXT
+constinit const std::array<U64, ROOK_ATTACK_TABLE_SIZE> rook_pext_attack_table =
+    generate_slider_attack_table<ROOK_ATTACK_TABLE_SIZE>(true, SliderBackend::pext);
+constinit const std::array<U64, BISHOP_ATTACK_TABLE_SIZE> bishop_pext_attack_table =
+    generate_slider_attack_table<BISHOP_ATTACK_TABLE_SIZE>(false, SliderBackend::pext);
 
-U64 bishop_attacks(int square, Board &game_state){
-    U64 magic_number = bishop_magic_numbers[square];
-    U64 relevant_occupancy = bishop_relevant_occupancy(square) & game_state.both_occupancy_bitboard;
-    int magic_index = relevant_occupancy * magic_number >> (64-bishop_relevant_occupancy_count[square]);
+constinit const std::array<MagicEntry, 64> rook_magic_table =
+    generate_magic_entries(true, rook_attack_table.data(), rook_pext_attack_table.data());
+constinit const std::array<MagicEntry, 64> bishop_magic_table =
+    generate_magic_entries(false, bishop_attack_table.data(), bishop_pext_attack_table.data());
+#else
+constinit const std::array<MagicEntry, 64> rook_magic_table =
+    generate_magic_entries(true, rook_attack_table.data(), nullptr);
+constinit const std::array<MagicEntry, 64> bishop_magic_table =
+    generate_magic_entries(false, bishop_attack_table.data(), nullptr);
+#endif
 
-    return bishop_lookup_attacks[square][magic_index];
-}
+constinit const std::array<std::array<U64, 64>, 64> between_squares = generate_between_squares();
+constinit const std::array<std::array<U64, 64>, 64> line_through_squares = generate_line_through_squares();
 
-U64 queen_attacks(int square, Board &game_state){
-    return (bishop_attacks(square, game_state) | rook_attacks(square, game_state));
-}
+SliderBackend slider_backend = SliderBackend::magic;
 
 // not in use
 // todo test
@@ -343,7 +193,7 @@ void print_relevant_occupancy_count_tables(){
     }
 }
 
-void generate_magic_numbers(bool rook, Board &game_state){
+void generate_magic_numbers(bool rook){
     // random number generator
     constexpr U64 SEED = 123456789ULL;
     std::mt19937_64 gen(SEED);
@@ -400,13 +250,7 @@ void generate_magic_numbers(bool rook, Board &game_state){
                 else
                     magic_index = relevant_occupancy * magic_number >> (64-bishop_relevant_occupancy_count[square]);
 
-                // set relevant occupancy to board
-                game_state.both_occupancy_bitboard = relevant_occupancy;
-                // oparates on both_occupancies
-                U64 attacks = rook ? calculate_rook_attacks(square, game_state) : calculate_bishop_attacks(square, game_state);
-                
-                // reset both_occupancy_bitboard
-                game_state.both_occupancy_bitboard = 0ULL;
+                U64 attacks = rook ? calculate_rook_attacks(square, relevant_occupancy) : calculate_bishop_attacks(square, relevant_occupancy);
 
                 if(attack_table[magic_index] && attack_table[magic_index] != attacks){
                     // failed! other magic number
@@ -441,67 +285,53 @@ void generate_magic_numbers(bool rook, Board &game_state){
     printf("correct numbers: %d\n",correct_numbers);
 }
 
-void init_rook_bishop_lookup_tables(bool rook, Board &game_state){
-    for(int square = 0; square < 64; square++){
-        for(int variation = 0; (variation < (rook ? 4096 : 512)); variation++){
-            U64 relevant_occupancy = 0ULL;
-            int index = 0;
-
-            U64 occupation_mask = rook ? 
-            rook_relevant_occupancy(square) : 
-            bishop_relevant_occupancy(square);
-
-            while(occupation_mask){
-                int mask_bit = get_LS1B(occupation_mask);
-                
-                // get bit from variation and put under set (1) bit in relevant_occupancy
-                U64 bit = (variation & (1ULL << index)) ? 1ULL : 0ULL;
-                relevant_occupancy |= (bit << mask_bit);
-                
-                pop_bit(occupation_mask);
-                index++;
-            }
-            int magic_index = rook ? 
-            relevant_occupancy * rook_magic_numbers[square] >> (64-rook_relevant_occupancy_count[square]) : 
-            relevant_occupancy * bishop_magic_numbers[square] >> (64-bishop_relevant_occupancy_count[square]);
-
-            // set relevant occupancy to board
-            game_state.both_occupancy_bitboard = relevant_occupancy;
-            // oparates on both_occupancies
-            U64 attacks = rook ? calculate_rook_attacks(square, game_state) : calculate_bishop_attacks(square, game_state);
-
-            if(rook)
-                rook_lookup_attacks[square][magic_index] = attacks;
-            else
-                bishop_lookup_attacks[square][magic_index] = attacks;
-        }   
+bool pext_supported(){
+#ifdef ENGINE_PEXT
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    // leaf 7 (structured extended features): BMI2 is bit 8 of ebx
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & bit_BMI2))
+        return false;
+
+    // vendor string: ebx, edx, ecx
+    char vendor[13] = {0};
+    __get_cpuid(0, &eax, &ebx, &ecx, &edx);
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+
+    // AMD Zen1 / Zen2 (family 17h) has microcoded pext (cost grows with mask bits)
+    // magics are faster there
+    if(std::strcmp(vendor, "AuthenticAMD") == 0){
+        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+        int family = (eax >> 8) & 0xf;
+        if(family == 0xf)
+            family += (eax >> 20) & 0xff;
+
+        if(family == 0x17)
+            return false;
     }
-}
 
-void init_pawn_lookup_table(){
-    for( int side = 0; side < 2; side++){
-        for (int square = 0; square < 64; square++){
-            pawn_lookup_attacks[side][square] = pawn_attacks(square, side);
-        }
-    }
+    return true;
+#else
+    return false;
+#endif
 }
 
-void init_king_lookup_table(){
-    for (int square = 0; square < 64; square++){
-        king_lookup_attacks[square] = king_attacks(square);
-    }
+bool set_slider_backend(SliderBackend backend){
+    if(backend == SliderBackend::pext && !pext_supported())
+        return false;
+
+    slider_backend = backend;
+
+    return true;
 }
 
-void init_knight_lookup_table(){
-    for (int square = 0; square < 64; square++){
-        knight_lookup_attacks[square] = knight_attacks(square);
-    }
+const char *slider_backend_name(SliderBackend backend){
+    return backend == SliderBackend::pext ? "pext" : "magic";
 }
 
-void init_all_lookup_tables(Board &game_state){
-    init_rook_bishop_lookup_tables(true, game_state);
-    init_rook_bishop_lookup_tables(false, game_state);
-    init_pawn_lookup_table();
-    init_king_lookup_table();
-    init_knight_lookup_table();
+void init_all_lookup_tables(){
+    // choose fastest backend available on this CPU
+    slider_backend = pext_supported() ? SliderBackend::pext : SliderBackend::magic;
 }
@@ -17,12 +17,20 @@ Board& Board::operator=(const Board &other)
             this->color_occupancy_bitboards[i] = other.color_occupancy_bitboards[i];
 
         this->both_occupancy_bitboard = other.both_occupancy_bitboard;
+        this->mailbox = other.mailbox;
+
+        this->hash_key = other.hash_key;
+        this->pawn_key = other.pawn_key;
+        this->material_key = other.material_key;
+        this->psqt_score = other.psqt_score;
 
         this->castles = other.castles;
         this->color_to_move = other.color_to_move;
         this->en_passant_square = other.en_passant_square;
         this->halfmove_counter = other.halfmove_counter;
         this->fullmove_number = other.fullmove_number;
+
+        this->history = other.history;
     }
 
     return *this;
@@ -36,6 +44,7 @@ void Board::clear_bitboards()
         color_occupancy_bitboards[0] = 0ULL;
         color_occupancy_bitboards[1] = 0ULL;
         both_occupancy_bitboard = 0ULL;
+        mailbox.fill(NO_PIECE);
     }
 
 void Board::load_fen(std::string fen)
@@ -92,6 +101,7 @@ void Board::load_fen(std::string fen)
 
         // add piece to bb
         bitboards[piece_ascii_to_number[fen_position[i]]] |= (1ULL << square);
+        mailbox[square] = piece_ascii_to_number[fen_position[i]];
         square++;
     }
 
@@ -180,6 +190,133 @@ void Board::load_fen(std::string fen)
     // *** 6.st fragment ***
     // set fullmove number
     fullmove_number = std::stoi(fen_fragments[5]);
+
+    // new position - no history
+    history.clear();
+
+    hash_key = compute_hash_key();
+    pawn_key = compute_pawn_key();
+    material_key = compute_material_key();
+    psqt_score = compute_psqt_score();
+}
+
+std::string Board::get_fen() const
+{
+    std::string fen;
+
+    // ranks from 8 to 1
+    for (int rank = 7; rank >= 0; rank--)
+    {
+        int empty = 0;
+        for (int file = 0; file < 8; file++)
+        {
+            int piece = mailbox[rank * 8 + file];
+            if (piece == NO_PIECE)
+            {
+                empty++;
+                continue;
+            }
+
+            if (empty)
+                fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += ascii_pieces[piece];
+        }
+
+        if (empty)
+            fen += static_cast<char>('0' + empty);
+        if (rank > 0)
+            fen += '/';
+    }
+
+    fen += color_to_move == static_cast<int>(COLOR::white) ? " w " : " b ";
+
+    std::string castles_str;
+    if (castles & 0b0100) castles_str += 'K';
+    if (castles & 0b1000) castles_str += 'Q';
+    if (castles & 0b0001) castles_str += 'k';
+    if (castles & 0b0010) castles_str += 'q';
+    fen += castles_str.empty() ? "-" : castles_str;
+
+    fen += ' ';
+    fen += en_passant_square == -1 ? "-" : square_str[en_passant_square];
+    fen += ' ' + std::to_string(halfmove_counter) + ' ' + std::to_string(fullmove_number);
+
+    return fen;
+}
+
+U64 Board::compute_hash_key() const
+{
+    U64 key = compute_pawn_key();
+
+    for (int piece = 0; piece < 12; piece++)
+    {
+        if (piece % 6 == static_cast<int>(PIECE::P))
+            continue;
+
+        U64 piece_bitboard = bitboards[piece];
+        while (piece_bitboard)
+        {
+            key ^= zobrist_piece_keys[piece][get_LS1B(piece_bitboard)];
+            pop_bit(piece_bitboard);
+        }
+    }
+
+    key ^= zobrist_castle_keys[castles];
+
+    if (en_passant_square != -1)
+        key ^= zobrist_en_passant_keys[en_passant_square % 8];
+
+    if (color_to_move == static_cast<int>(COLOR::black))
+        key ^= zobrist_side_key;
+
+    return key;
+}
+
+U64 Board::compute_pawn_key() const
+{
+    U64 key = 0ULL;
+
+    for (int piece : {static_cast<int>(PIECE::P), static_cast<int>(PIECE::p)})
+    {
+        U64 piece_bitboard = bitboards[piece];
+        while (piece_bitboard)
+        {
+            key ^= zobrist_piece_keys[piece][get_LS1B(piece_bitboard)];
+            pop_bit(piece_bitboard);
+        }
+    }
+
+    return key;
+}
+
+U64 Board::compute_material_key() const
+{
+    U64 key = 0ULL;
+
+    // one key for every piece of given type: [piece][0], [piece][1], ...
+    for (int piece = 0; piece < 12; piece++)
+        for (int count = 0; count < std::popcount(bitboards[piece]); count++)
+            key ^= zobrist_piece_keys[piece][count];
+
+    return key;
+}
+
+int Board::compute_psqt_score() const
+{
+    int score = 0;
+
+    for (int piece = 0; piece < 12; piece++)
+    {
+        U64 piece_bitboard = bitboards[piece];
+        while (piece_bitboard)
+        {
+            score += piece_square_scores[piece][get_LS1B(piece_bitboard)];
+            pop_bit(piece_bitboard);
+        }
+    }
+
+    return score;
 }
 
 void Board::print_game_state()
@@ -278,24 +415,10 @@ void Board::print_board_ascii(Board &game_state){
 std::array<char, 64> Board::board_to_char_array()
 {
     std::array<char, 64> arr{};
-    arr.fill('-'); // wypełniamy domyślnie pustym polem
 
-    // iterujemy po wszystkich typach figur (12 bitboardów)
-    for (int bitboard_index = 0; bitboard_index < 12; bitboard_index++)
-    {
-        U64 piece_bitboard = bitboards[bitboard_index];
-
-        while (piece_bitboard)
-        {
-            int square_number = get_LS1B(piece_bitboard);
-
-            // przypisujemy odpowiedni znak ASCII do pola
-            arr[square_number] = ascii_pieces[bitboard_index];
-
-            // usuwamy LS1B
-            piece_bitboard &= (piece_bitboard - 1);
-        }
-    }
+    // odczyt z mailboxa ('-' puste pole)
+    for (int square = 0; square < 64; square++)
+        arr[square] = mailbox[square] == NO_PIECE ? '-' : ascii_pieces[mailbox[square]];
 
     return arr;
-}
\ No newline at end of file
+}
@@ -64,59 +64,67 @@ using U64 = uint64_t;
 // *             MAIN
 // ************************************
 
+// usage: engine_test [hash_mb] [max_depth]
+// hash_mb > 0: every depth is run without and with perft hash table, results compared, speedup reported
 int main(int argc, char const *argv[])
 {
     // ------------------------------------------------------
     // INIT
     Board board;
-    init_all_lookup_tables(board);
+    init_all_lookup_tables();
     
     // load fen
     board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"); // starting
     // board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"); // starting
     // board.load_fen("k7/8/8/8/8/8/8/K3Q3 w - - 0 1");
 
+    const int hash_mb = argc > 1 ? std::stoi(argv[1]) : 0;
+    const int max_depth = argc > 2 ? std::stoi(argv[2]) : 7;
+
     // ------------------------------------------------------
 
-    auto moves = generate_moves(board);
-    // auto moves = generate_legal_moves(board);
+    MoveList moves;
+    generate_moves(board, moves);
+    // generate_legal_moves(board, moves);
 
-    char c;
     for(const Move & move : moves){
         move.print();
-        // std::cin >> c;
     }
 
-    /* U64 test = 0ULL;
-
-    for(int i = 0; i < 64; i++){
-        if(is_square_attacked_by(i, 1, board)){
-            test |= (1ULL << i);
-        }
+    PerftTable *table = nullptr;
+    if(hash_mb > 0){
+        table = new PerftTable(hash_mb);
+        printf("perft hash: %d MB, %zu entries\n", hash_mb, table->size());
     }
 
-    print_bitboard_bits(test); */
-
-
-    // std::cout << isKingUnderAttack(board);
-
-    for(int i = 1; i < 8; i++){
+    bool mismatch = false;
+    for(int i = 1; i <= max_depth; i++){
         printf("%d: ", i);
+        auto start = std::chrono::steady_clock::now();
         PerftMovesCount pmc = perf(i, board);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         printPerftObject(pmc);
+
+        if(table){
+            // fresh table for every depth - speedup comes from transpositions inside one tree
+            table->clear();
+            start = std::chrono::steady_clock::now();
+            PerftMovesCount hashed = perf(i, board, table);
+            double hashed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            printf("   %.3f s, with hash %.3f s (x%.2f) %s\n", seconds, hashed_seconds, seconds / hashed_seconds,
+                   hashed == pmc ? "ok" : "MISMATCH");
+            if(!(hashed == pmc))
+                mismatch = true;
+        }
     }
 
-    // printf("1: count: %llu, captures: %llu, en_pasants: %llu, checks: %llu, checkmates: %llu  \n", pmc1.count, pmc1.en_pasants, pmc1.captures, pmc1.checks,  pmc1.checkmates);
-    // printf("2: count: %llu, captures: %llu, en_pasants: %llu, checks: %llu, checkmates: %llu  \n", pmc2.count, pmc2.en_pasants, pmc2.captures, pmc2.checks,  pmc2.checkmates);
-    // printf("3: count: %llu, captures: %llu, en_pasants: %llu, checks: %llu, checkmates: %llu  \n", pmc3.count, pmc3.en_pasants, pmc3.captures, pmc3.checks,  pmc3.checkmates);
-    // printf("4: count: %llu, captures: %llu, en_pasants: %llu, checks: %llu, checkmates: %llu  \n", pmc4.count, pmc4.en_pasants, pmc4.captures, pmc4.checks,  pmc4.checkmates);
-    // printf("5: count: %llu, captures: %llu, en_pasants: %llu, checks: %llu, checkmates: %llu  \n", pmc5.count, pmc5.en_pasants, pmc5.captures, pmc5.checks,  pmc5.checkmates);
-    
-    
-    return 0;
+    delete table;
+
+    return mismatch ? 1 : 0;
 }
 
 // todo
 // - test generate moves (perf)
 // - test make move & take back move (copy and save game state)
-// - GUI
\ No newline at end of file
+// - GUI
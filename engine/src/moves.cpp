@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cassert>
+
 #include "moves.hpp"
 #include "constants.hpp"
 #include "utility.hpp"
@@ -16,6 +19,16 @@ void Move::print() const{
     << ascii_pieces[this->get_piece()] << " " << move_type_str[this->get_move_type()] << "\n";
 }
 
+std::string Move::to_uci() const{
+    std::string uci = square_str[this->get_from_square()] + square_str[this->get_to_square()];
+
+    // promotion piece (knight, bishop, rook, queen)
+    if(this->get_move_type() & static_cast<int>(MoveType::knight_promotion))
+        uci += "nbrq"[this->get_move_type() & 0b11];
+
+    return uci;
+}
+
 bool is_square_attacked_by(int square, int side, Board &game_state){
     // super-piece technic
     // set pieces on current <square> and intersect attacks with appropriate pieces
@@ -68,13 +81,12 @@ U64 get_attacked_squares(int side, Board &game_state){
     return result;
 }
 
-std::vector<Move> generate_moves(Board &game_state){
+template<GenType gen_type>
+void generate_moves_of_type(Board &game_state, MoveList &moves){
     int from_square = 0, to_square = 0;
     U64 pice_bitboard_copy = 0ULL;
     U64 attacks = 0ULL;
 
-    std::vector<Move> moves;
-
     //for each piece type in <color_to_move>
     for(int piece = static_cast<int>(PIECE::P) + (game_state.color_to_move*6); piece <= static_cast<int>(PIECE::K) + (game_state.color_to_move*6); piece++){
         pice_bitboard_copy = game_state.bitboards[piece];
@@ -90,8 +102,8 @@ std::vector<Move> generate_moves(Board &game_state){
                     (from_square >= static_cast<int>(SQUARE::a7) && from_square <= static_cast<int>(SQUARE::h7) && game_state.color_to_move == static_cast<int>(COLOR::white)) ||
                     (from_square >= static_cast<int>(SQUARE::a2) && from_square <= static_cast<int>(SQUARE::h2) && game_state.color_to_move == static_cast<int>(COLOR::black));
 
-                // attacks
-                attacks = pawn_lookup_attacks[game_state.color_to_move][from_square];
+                // attacks (none in quiets mode)
+                attacks = gen_type == GenType::quiets ? 0ULL : pawn_lookup_attacks[game_state.color_to_move][from_square];
 
                 // for each attacking square
                 while (attacks){
@@ -141,7 +153,15 @@ std::vector<Move> generate_moves(Board &game_state){
                 to_square = game_state.color_to_move == static_cast<int>(COLOR::white) ? from_square + 8 : from_square - 8;
                 bool is_target_square_empty = ( game_state.both_occupancy_bitboard & (1ULL << to_square) ) == 0;
 
-                if(is_target_square_empty){
+                // captures mode: only queen promotion
+                if constexpr (gen_type == GenType::captures){
+                    if(is_target_square_empty && is_on_promotion){
+                        Move move;
+                        move.encode_move(from_square, to_square, static_cast<int>(PIECE::P) + (game_state.color_to_move*6), MoveType::queen_promotion);
+                        moves.push_back(move);
+                    }
+                }
+                else if(is_target_square_empty){
                     if(is_on_promotion){
                         Move move[4];
                         move[0].encode_move(from_square, to_square, static_cast<int>(PIECE::P) + (game_state.color_to_move*6), MoveType::rook_promotion);
@@ -151,7 +171,9 @@ std::vector<Move> generate_moves(Board &game_state){
                         moves.push_back(move[0]);
                         moves.push_back(move[1]);
                         moves.push_back(move[2]);
-                        moves.push_back(move[3]);
+                        // queen promotion belongs to captures mode
+                        if constexpr (gen_type == GenType::all)
+                            moves.push_back(move[3]);
                         // std::cout << "Pawn promotion Rr: " << square_str[from_square] << square_str[to_square] << "\n";
                         // std::cout << "Pawn promotion Nn: " << square_str[from_square] << square_str[to_square] << "\n";
                         // std::cout << "Pawn promotion Bb: " << square_str[from_square] << square_str[to_square] << "\n";
@@ -184,6 +206,10 @@ std::vector<Move> generate_moves(Board &game_state){
             //* knight moves
             if(piece == static_cast<int>(PIECE::N) || piece == static_cast<int>(PIECE::n)){
                 attacks = knight_lookup_attacks[from_square];
+                if constexpr (gen_type == GenType::captures)
+                    attacks &= game_state.color_occupancy_bitboards[!game_state.color_to_move];
+                if constexpr (gen_type == GenType::quiets)
+                    attacks &= ~game_state.both_occupancy_bitboard;
 
                 while(attacks){
                     to_square = get_LS1B(attacks);
@@ -210,6 +236,10 @@ std::vector<Move> generate_moves(Board &game_state){
             //* bishop moves
             if(piece == static_cast<int>(PIECE::B) || piece == static_cast<int>(PIECE::b)){
                 attacks = bishop_attacks(from_square, game_state);
+                if constexpr (gen_type == GenType::captures)
+                    attacks &= game_state.color_occupancy_bitboards[!game_state.color_to_move];
+                if constexpr (gen_type == GenType::quiets)
+                    attacks &= ~game_state.both_occupancy_bitboard;
 
                 while(attacks){
                     to_square = get_LS1B(attacks);
@@ -236,6 +266,10 @@ std::vector<Move> generate_moves(Board &game_state){
             //* rook moves
             if(piece == static_cast<int>(PIECE::R) || piece == static_cast<int>(PIECE::r)){
                 attacks = rook_attacks(from_square, game_state);
+                if constexpr (gen_type == GenType::captures)
+                    attacks &= game_state.color_occupancy_bitboards[!game_state.color_to_move];
+                if constexpr (gen_type == GenType::quiets)
+                    attacks &= ~game_state.both_occupancy_bitboard;
 
                 while(attacks){
                     to_square = get_LS1B(attacks);
@@ -262,6 +296,10 @@ std::vector<Move> generate_moves(Board &game_state){
             //* queen moves
             if(piece == static_cast<int>(PIECE::Q) || piece == static_cast<int>(PIECE::q)){
                 attacks = queen_attacks(from_square, game_state);
+                if constexpr (gen_type == GenType::captures)
+                    attacks &= game_state.color_occupancy_bitboards[!game_state.color_to_move];
+                if constexpr (gen_type == GenType::quiets)
+                    attacks &= ~game_state.both_occupancy_bitboard;
 
                 while(attacks){
                     to_square = get_LS1B(attacks);
@@ -288,6 +326,10 @@ std::vector<Move> generate_moves(Board &game_state){
             //* king moves
             if(piece == static_cast<int>(PIECE::K) || piece == static_cast<int>(PIECE::k)){
                 attacks = king_lookup_attacks[from_square];
+                if constexpr (gen_type == GenType::captures)
+                    attacks &= game_state.color_occupancy_bitboards[!game_state.color_to_move];
+                if constexpr (gen_type == GenType::quiets)
+                    attacks &= ~game_state.both_occupancy_bitboard;
 
                 while(attacks){
                     to_square = get_LS1B(attacks);
@@ -310,7 +352,12 @@ std::vector<Move> generate_moves(Board &game_state){
                     pop_bit(attacks);
                 }
 
-                // castling
+                // castling (not in captures mode)
+                if constexpr (gen_type == GenType::captures){
+                    pop_bit(pice_bitboard_copy);
+                    continue;
+                }
+
                 // castle system - each bit describes one possibility
                 // | white queenside | white kingside | black queenside | black kingside |
                 // |      bit 0/1    |     bit 0/1    |     bit 0/1     |    bit 0/1     |
@@ -387,313 +434,627 @@ std::vector<Move> generate_moves(Board &game_state){
             pop_bit(pice_bitboard_copy);
         }
     }
+}
 
-    return moves;
+void generate_moves(Board &game_state, MoveList &moves, GenType gen_type){
+    if(gen_type == GenType::captures)
+        generate_moves_of_type<GenType::captures>(game_state, moves);
+    else if(gen_type == GenType::quiets)
+        generate_moves_of_type<GenType::quiets>(game_state, moves);
+    else
+        generate_moves_of_type<GenType::all>(game_state, moves);
 }
 
+bool is_pseudo_legal(const Move &move, Board &board){
+    const int from_square = move.get_from_square();
+    const int to_square = move.get_to_square();
+    const int piece = move.get_piece();
+    const int move_type = move.get_move_type();
+    const int color = board.color_to_move;
+
+    if(move.encoded_value == 0 || piece / 6 != color || board.piece_on_square(from_square) != piece)
+        return false;
+
+    // castles and en passant are rare - looked up in generated moves
+    if(move_type == static_cast<int>(MoveType::king_castle) || move_type == static_cast<int>(MoveType::queen_castle) ||
+       move_type == static_cast<int>(MoveType::en_passant_capture)){
+        MoveList moves;
+        generate_moves(board, moves);
+        return std::any_of(moves.begin(), moves.end(), [&](const Move &m){ return m.encoded_value == move.encoded_value; });
+    }
 
-void make_move(Move move, Board &board){
-    // GAME STATE UPDATE AT THE END OF FUNCTION DEFINITION
-    // color_to_move & color_occupancies & full- half move count
-    //
-    // enemy color occupancy update on CAPTURE MOVE block
+    // capture flag must match target square
+    const int target = board.piece_on_square(to_square);
+    const bool is_capture = move_type & static_cast<int>(MoveType::capture);
+    if(is_capture ? (target == NO_PIECE || target / 6 == color) : target != NO_PIECE)
+        return false;
+
+    if(piece % 6 == static_cast<int>(PIECE::P)){
+        const bool is_last_rank = color == static_cast<int>(COLOR::white) ? to_square >= static_cast<int>(SQUARE::a8) : to_square <= static_cast<int>(SQUARE::h1);
+        const bool is_promotion = move_type & static_cast<int>(MoveType::knight_promotion);
+        const int forward = color == static_cast<int>(COLOR::white) ? 8 : -8;
+
+        if(is_promotion != is_last_rank)
+            return false;
+        if(is_capture)
+            return pawn_lookup_attacks[color][from_square] & (1ULL << to_square);
+        if(move_type == static_cast<int>(MoveType::double_pawn_push)){
+            const bool is_on_starting_rank = color == static_cast<int>(COLOR::white) ?
+                from_square >= static_cast<int>(SQUARE::a2) && from_square <= static_cast<int>(SQUARE::h2) :
+                from_square >= static_cast<int>(SQUARE::a7) && from_square <= static_cast<int>(SQUARE::h7);
+            return is_on_starting_rank && to_square == from_square + 2 * forward && board.piece_on_square(from_square + forward) == NO_PIECE;
+        }
+        return (move_type == static_cast<int>(MoveType::quiet_move) || is_promotion) && to_square == from_square + forward;
+    }
+
+    if(move_type != static_cast<int>(MoveType::quiet_move) && move_type != static_cast<int>(MoveType::capture))
+        return false;
+
+    U64 attacks = 0ULL;
+    switch(piece % 6){
+        case static_cast<int>(PIECE::N): attacks = knight_lookup_attacks[from_square]; break;
+        case static_cast<int>(PIECE::B): attacks = bishop_attacks(from_square, board); break;
+        case static_cast<int>(PIECE::R): attacks = rook_attacks(from_square, board); break;
+        case static_cast<int>(PIECE::Q): attacks = queen_attacks(from_square, board); break;
+        case static_cast<int>(PIECE::K): attacks = king_lookup_attacks[from_square]; break;
+    }
+
+    return attacks & (1ULL << to_square);
+}
+
+std::vector<Move> generate_moves(Board &game_state){
+    MoveList moves;
+    generate_moves(game_state, moves);
+
+    return std::vector<Move>(moves.begin(), moves.end());
+}
+
+
+// castle move -> rook from / to square
+inline void castle_rook_squares(int move_type, int color, int &rook_from_square, int &rook_to_square){
+    if(move_type == static_cast<int>(MoveType::king_castle)){
+        rook_from_square = color ? static_cast<int>(SQUARE::h8) : static_cast<int>(SQUARE::h1);
+        rook_to_square = rook_from_square - 2;
+    }
+    else{
+        rook_from_square = color ? static_cast<int>(SQUARE::a8) : static_cast<int>(SQUARE::a1);
+        rook_to_square = rook_from_square + 3;
+    }
+}
+
+void make_move(Move move, Board &board, Undo &undo){
+    const int from_square = move.get_from_square();
+    const int to_square = move.get_to_square();
+    const int piece = move.get_piece();
+    const int move_type = move.get_move_type();
+    const int us = board.color_to_move;
+    const int them = !us;
+
+    // save irreversible state
+    undo.move = move.encoded_value;
+    undo.captured_piece = NO_PIECE;
+    undo.castles = board.castles;
+    undo.en_passant_square = board.en_passant_square;
+    undo.halfmove_counter = board.halfmove_counter;
+    undo.hash_key = board.hash_key;
 
     // reset en passant square
     // if double push flag will be set
+    if(board.en_passant_square != -1)
+        board.hash_key ^= zobrist_en_passant_keys[board.en_passant_square % 8];
     board.en_passant_square = -1;
 
     //* UPDATE CASTLE RIGHTS
-    // if rook ON A or H rank update castle rights
-    if(move.get_piece() == static_cast<int>(PIECE::R)){
-        if( A_FILE_MASK & (1ULL << move.get_from_square()) ){
-            // white queen
-            board.castles &= 0b0111;
-        }
-        else if( H_FILE_MASK & (1ULL << move.get_from_square()) ){
-            // white king
-            board.castles &= 0b1011;
-        }
+    // king or rook moved from its starting square, or rook captured on it
+    board.hash_key ^= zobrist_castle_keys[board.castles];
+    board.castles &= castle_rights_update[from_square] & castle_rights_update[to_square];
+    board.hash_key ^= zobrist_castle_keys[board.castles];
+
+    //* CAPTURE (also promo capture)
+    if(move_type == static_cast<int>(MoveType::en_passant_capture)){
+        // to target square add offset (for white -8 for black +8)
+        const int enemy_pawn_square = to_square + (us*2 - 1)*8;
+        undo.captured_piece = static_cast<int>(PIECE::P) + them*6;
+        board.remove_piece(undo.captured_piece, enemy_pawn_square);
     }
-    else if(move.get_piece() == static_cast<int>(PIECE::r)){
-        if( A_FILE_MASK & (1ULL << move.get_from_square()) ){
-            // black queen
-            board.castles &= 0b1101;
-        }
-        else if( H_FILE_MASK & (1ULL << move.get_from_square()) ){
-            // black king
-            board.castles &= 0b1110;
-        }
+    else if(move_type & static_cast<int>(MoveType::capture)){
+        undo.captured_piece = board.piece_on_square(to_square);
+        board.remove_piece(undo.captured_piece, to_square);
     }
 
-    // if king remove castle right for that color
-    else if(move.get_piece() == static_cast<int>(PIECE::K)){
-        // white
-        board.castles &= 0b0011;
+    //* PAWN PROMOTION
+    if(move_type & static_cast<int>(MoveType::knight_promotion)){
+        board.remove_piece(piece, from_square);
+        board.put_piece(promotion_piece[move_type & 0b11] + us*6, to_square);
     }
-    else if(move.get_piece() == static_cast<int>(PIECE::k)){
-        // black
-        board.castles &= 0b1100;
+    else{
+        board.move_piece(piece, from_square, to_square);
     }
 
+    //* CASTLE - king already moved, move rook
+    // castle rights updated at the start of function
+    if(move_type == static_cast<int>(MoveType::king_castle) || move_type == static_cast<int>(MoveType::queen_castle)){
+        int rook_from_square, rook_to_square;
+        castle_rook_squares(move_type, us, rook_from_square, rook_to_square);
+        board.move_piece(static_cast<int>(PIECE::R) + us*6, rook_from_square, rook_to_square);
+    }
 
-    //* QUIET MOVE
-    if(move.get_move_type() == static_cast<int>(MoveType::quiet_move)){
-        // UPDATE BITBOARDS [PICES]
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[move.get_piece()] |= 1ULL << move.get_to_square();
+    //* MoveType::double_pawn_push
+    // set en passant square
+    if(move_type == static_cast<int>(MoveType::double_pawn_push)){
+        board.en_passant_square = (from_square + to_square) / 2;
+        board.hash_key ^= zobrist_en_passant_keys[board.en_passant_square % 8];
     }
 
+    // update game state
+    // halfmove clock resets on pawn move or capture
+    if(piece == static_cast<int>(PIECE::P) + us*6 || undo.captured_piece != NO_PIECE)
+        board.halfmove_counter = 0;
+    else
+        board.halfmove_counter += 1;
 
-    //* CAPTURE
-    if(move.get_move_type() == static_cast<int>(MoveType::capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        
-        // remove target square
-        for(int i = static_cast<int>(PIECE::P); i < static_cast<int>(PIECE::p); i++){
-            board.bitboards[i+((!board.color_to_move)*6)] &= ~( 1ULL << move.get_to_square() );
-        }
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~( 1ULL << move.get_to_square() );
-        
-        // set target square
-        board.bitboards[move.get_piece()] |= 1ULL << move.get_to_square();
+    if(us == static_cast<int>(COLOR::black))
+        board.fullmove_number += 1;
+
+    // update color to move game state
+    board.color_to_move = them;
+    board.hash_key ^= zobrist_side_key;
+}
+
+void make_move(Move move, Board &board){
+    Undo undo;
+    make_move(move, board, undo);
+}
 
+void unmake_move(Move move, const Undo &undo, Board &board){
+    const int from_square = move.get_from_square();
+    const int to_square = move.get_to_square();
+    const int piece = move.get_piece();
+    const int move_type = move.get_move_type();
+
+    // side that made the move
+    const int us = !board.color_to_move;
+    board.color_to_move = us;
+
+    if(move_type == static_cast<int>(MoveType::king_castle) || move_type == static_cast<int>(MoveType::queen_castle)){
+        int rook_from_square, rook_to_square;
+        castle_rook_squares(move_type, us, rook_from_square, rook_to_square);
+        board.move_piece(static_cast<int>(PIECE::R) + us*6, rook_to_square, rook_from_square);
     }
 
-    
-    //* MoveType::double_pawn_push
-    // double push
-    // sett en passant flag
-    if(move.get_move_type() == static_cast<int>(MoveType::double_pawn_push)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[move.get_piece()] |= 1ULL << move.get_to_square();
+    if(move_type & static_cast<int>(MoveType::knight_promotion)){
+        board.remove_piece(promotion_piece[move_type & 0b11] + us*6, to_square);
+        board.put_piece(piece, from_square);
+    }
+    else{
+        board.move_piece(piece, to_square, from_square);
+    }
 
-        // set en passant square
-        board.en_passant_square = (move.get_from_square() + move.get_to_square()) / 2;
+    if(move_type == static_cast<int>(MoveType::en_passant_capture)){
+        board.put_piece(undo.captured_piece, to_square + (us*2 - 1)*8);
+    }
+    else if(undo.captured_piece != NO_PIECE){
+        board.put_piece(undo.captured_piece, to_square);
     }
 
+    // restore game state
+    board.castles = undo.castles;
+    board.en_passant_square = undo.en_passant_square;
+    board.halfmove_counter = undo.halfmove_counter;
+    // piece keys are restored by put/remove/move_piece, pawn and material keys too
+    board.hash_key = undo.hash_key;
+    if(us == static_cast<int>(COLOR::black))
+        board.fullmove_number -= 1;
+}
 
-    //* MoveType::en_passant_capture
-    if(move.get_move_type() == static_cast<int>(MoveType::en_passant_capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[move.get_piece()] |= 1ULL << move.get_to_square();
+void make_null_move(Board &board, Undo &undo){
+    undo.move = 0;
+    undo.captured_piece = NO_PIECE;
+    undo.castles = board.castles;
+    undo.en_passant_square = board.en_passant_square;
+    undo.halfmove_counter = board.halfmove_counter;
+    undo.hash_key = board.hash_key;
 
-        // remove enemy pawn
-        // to target square add offset (for white -8 for black +8)
-        const int enemy_pawn_square = move.get_to_square() + (board.color_to_move*2 - 1)*8;
-        board.bitboards[static_cast<int>(PIECE::P) + ((!board.color_to_move)*6)] &= ~(1ULL << enemy_pawn_square);
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~(1ULL << enemy_pawn_square);
-    }
+    if(board.en_passant_square != -1)
+        board.hash_key ^= zobrist_en_passant_keys[board.en_passant_square % 8];
+    board.en_passant_square = -1;
 
-    //* PAWN PROMOTION
-    // rook
-    if(move.get_move_type() == static_cast<int>(MoveType::rook_promotion)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+    board.halfmove_counter += 1;
+    if(board.color_to_move == static_cast<int>(COLOR::black))
+        board.fullmove_number += 1;
+
+    board.color_to_move = !board.color_to_move;
+    board.hash_key ^= zobrist_side_key;
+}
+
+void unmake_null_move(const Undo &undo, Board &board){
+    board.color_to_move = !board.color_to_move;
+    if(board.color_to_move == static_cast<int>(COLOR::black))
+        board.fullmove_number -= 1;
+
+    board.en_passant_square = undo.en_passant_square;
+    board.halfmove_counter = undo.halfmove_counter;
+    board.hash_key = undo.hash_key;
+}
+
+void push_move(Move move, Board &board){
+    make_move(move, board, board.history.emplace_back());
+}
+
+void pop_move(Board &board){
+    assert(!board.history.empty());
+    const Undo &undo = board.history.back();
+    Move move;
+    move.encoded_value = undo.move;
+    unmake_move(move, undo, board);
+    board.history.pop_back();
+}
+
+void push_null_move(Board &board){
+    make_null_move(board, board.history.emplace_back());
+}
+
+void pop_null_move(Board &board){
+    assert(!board.history.empty());
+    unmake_null_move(board.history.back(), board);
+    board.history.pop_back();
+}
+
+bool isMoveLegal(const Move &move, Board &board){
+    // make move
+    Undo undo;
+    make_move(move, board, undo);
+
+    // check wheter king is in check
+    int king_square = get_LS1B(board.bitboards[static_cast<int>(PIECE::K) + (!board.color_to_move * 6)]);
+    bool isLegal = !is_square_attacked_by(king_square, board.color_to_move, board);
+
+    unmake_move(move, undo, board);
+
+    return isLegal;
+}
+
+// squares attacked by <side> pieces, with given occupancy
+// (legal generator passes occupancy without own king - king can't hide behind itself)
+U64 get_attacked_squares_mask(int side, U64 occupancy, Board &game_state){
+    const U64 *bitboards = game_state.bitboards + side * 6;
+    U64 attacks = 0ULL;
+
+    // pawns (set-wise)
+    U64 pawns = bitboards[static_cast<int>(PIECE::P)];
+    if(side == static_cast<int>(COLOR::white))
+        attacks |= ((pawns << 9) & NOT_A_FILE) | ((pawns << 7) & NOT_H_FILE);
+    else
+        attacks |= ((pawns >> 7) & NOT_A_FILE) | ((pawns >> 9) & NOT_H_FILE);
+
+    U64 knights = bitboards[static_cast<int>(PIECE::N)];
+    while(knights){
+        attacks |= knight_lookup_attacks[get_LS1B(knights)];
+        pop_bit(knights);
     }
-    // bishop
-    else if(move.get_move_type() == static_cast<int>(MoveType::bishop_promotion)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::B) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+
+    U64 diagonal_sliders = bitboards[static_cast<int>(PIECE::B)] | bitboards[static_cast<int>(PIECE::Q)];
+    while(diagonal_sliders){
+        attacks |= bishop_attacks(get_LS1B(diagonal_sliders), occupancy);
+        pop_bit(diagonal_sliders);
     }
-    // knight
-    else if(move.get_move_type() == static_cast<int>(MoveType::knight_promotion)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::N) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+
+    U64 orthogonal_sliders = bitboards[static_cast<int>(PIECE::R)] | bitboards[static_cast<int>(PIECE::Q)];
+    while(orthogonal_sliders){
+        attacks |= rook_attacks(get_LS1B(orthogonal_sliders), occupancy);
+        pop_bit(orthogonal_sliders);
     }
-    // queen
-    else if(move.get_move_type() == static_cast<int>(MoveType::queen_promotion)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::Q) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+
+    U64 king = bitboards[static_cast<int>(PIECE::K)];
+    if(king)
+        attacks |= king_lookup_attacks[get_LS1B(king)];
+
+    return attacks;
+}
+
+// add moves of one piece to every target square (capture if enemy stands there)
+inline void add_piece_moves(MoveList &moves, int from_square, U64 targets, int piece, U64 enemy_occupancy){
+    while(targets){
+        int to_square = get_LS1B(targets);
+        Move move;
+        move.encode_move(from_square, to_square, piece, (enemy_occupancy & (1ULL << to_square)) ? MoveType::capture : MoveType::quiet_move);
+        moves.push_back(move);
+        pop_bit(targets);
     }
+}
 
-    //* MoveType::rook_promo_capture
-    // rook
-    if(move.get_move_type() == static_cast<int>(MoveType::rook_promo_capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        
-        // remove target square
-        for(int i = 0; i < 6; i++){
-            board.bitboards[i+((!board.color_to_move)*6)] &= ~( 1ULL << move.get_to_square() );
-        }
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~( 1ULL << move.get_to_square() );
+// same order as in generate_moves
+inline void add_promotions(MoveList &moves, int from_square, int to_square, int piece, bool capture){
+    Move move;
+    move.encode_move(from_square, to_square, piece, capture ? MoveType::rook_promo_capture : MoveType::rook_promotion);
+    moves.push_back(move);
+    move.encode_move(from_square, to_square, piece, capture ? MoveType::bishop_promo_capture : MoveType::bishop_promotion);
+    moves.push_back(move);
+    move.encode_move(from_square, to_square, piece, capture ? MoveType::knight_promo_capture : MoveType::knight_promotion);
+    moves.push_back(move);
+    move.encode_move(from_square, to_square, piece, capture ? MoveType::queen_promo_capture : MoveType::queen_promotion);
+    moves.push_back(move);
+}
 
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+// fully legal generator
+// checkers, pinned pieces and king danger squares are computed once per position,
+// every piece is then restricted to:
+// - check mask (capture checker / block the ray; nothing in double check)
+// - pin ray (line through king and pinned piece)
+// king never steps on a square attacked by enemy (attacks computed without our king)
+void generate_legal_moves(Board &game_state, MoveList &legal_moves){
+    const int us = game_state.color_to_move;
+    const int them = !us;
+    const int piece_offset = us * 6;
+    const U64 *our_bitboards = game_state.bitboards + us * 6;
+    const U64 *their_bitboards = game_state.bitboards + them * 6;
+
+    const U64 occupancy = game_state.both_occupancy_bitboard;
+    const U64 our_occupancy = game_state.color_occupancy_bitboards[us];
+    const U64 their_occupancy = game_state.color_occupancy_bitboards[them];
+
+    const U64 king_bitboard = our_bitboards[static_cast<int>(PIECE::K)];
+    const int king_square = get_LS1B(king_bitboard);
+
+    const U64 their_diagonal_sliders = their_bitboards[static_cast<int>(PIECE::B)] | their_bitboards[static_cast<int>(PIECE::Q)];
+    const U64 their_orthogonal_sliders = their_bitboards[static_cast<int>(PIECE::R)] | their_bitboards[static_cast<int>(PIECE::Q)];
+
+    //* CHECKERS
+    U64 checkers =
+        (pawn_lookup_attacks[us][king_square] & their_bitboards[static_cast<int>(PIECE::P)]) |
+        (knight_lookup_attacks[king_square] & their_bitboards[static_cast<int>(PIECE::N)]) |
+        (bishop_attacks(king_square, occupancy) & their_diagonal_sliders) |
+        (rook_attacks(king_square, occupancy) & their_orthogonal_sliders);
+
+    //* KING DANGER SQUARES
+    const U64 danger = get_attacked_squares_mask(them, occupancy ^ king_bitboard, game_state);
+
+    //* KING MOVES
+    add_piece_moves(legal_moves, king_square, king_lookup_attacks[king_square] & ~our_occupancy & ~danger, static_cast<int>(PIECE::K) + piece_offset, their_occupancy);
+
+    // double check - only king can move
+    if(std::popcount(checkers) > 1)
+        return;
+
+    // squares that resolve check (all squares if not in check)
+    U64 check_mask = ~0ULL;
+    if(checkers){
+        int checker_square = get_LS1B(checkers);
+        check_mask = checkers | between_squares[king_square][checker_square];
     }
-    // bishop
-    else if(move.get_move_type() == static_cast<int>(MoveType::bishop_promo_capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
 
-        // remove target square
-        for(int i = 0; i < 6; i++){
-            board.bitboards[i+((!board.color_to_move)*6)] &= ~( 1ULL << move.get_to_square() );
-        }
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~( 1ULL << move.get_to_square() );
+    //* PINS
+    // enemy sliders seeing our king through exactly one our piece
+    U64 pinned = 0ULL;
+    U64 snipers =
+        (bishop_attacks(king_square, their_occupancy) & their_diagonal_sliders) |
+        (rook_attacks(king_square, their_occupancy) & their_orthogonal_sliders);
+    while(snipers){
+        int sniper_square = get_LS1B(snipers);
+        U64 blockers = between_squares[king_square][sniper_square] & occupancy;
 
+        if(std::popcount(blockers) == 1 && (blockers & our_occupancy))
+            pinned |= blockers;
 
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::B) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
+        pop_bit(snipers);
     }
-    // knight
-    else if(move.get_move_type() == static_cast<int>(MoveType::knight_promo_capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
 
-        // remove target square
-        for(int i = 0; i < 6; i++){
-            board.bitboards[i+((!board.color_to_move)*6)] &= ~( 1ULL << move.get_to_square() );
-        }
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~( 1ULL << move.get_to_square() );
+    //* PIECES (knight, bishop, rook, queen)
+    const U64 targets_mask = ~our_occupancy & check_mask;
+    for(int piece = static_cast<int>(PIECE::R); piece <= static_cast<int>(PIECE::Q); piece++){
+        U64 piece_bitboard = our_bitboards[piece];
 
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::N) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
-    }
-    // queen
-    else if(move.get_move_type() == static_cast<int>(MoveType::queen_promo_capture)){
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
+        // pinned knight can never move
+        if(piece == static_cast<int>(PIECE::N))
+            piece_bitboard &= ~pinned;
+
+        while(piece_bitboard){
+            int from_square = get_LS1B(piece_bitboard);
 
-        // remove target square
-        for(int i = 0; i < 6; i++){
-            board.bitboards[i+((!board.color_to_move)*6)] &= ~( 1ULL << move.get_to_square() );
+            U64 targets = 0ULL;
+            if(piece == static_cast<int>(PIECE::N))
+                targets = knight_lookup_attacks[from_square];
+            else if(piece == static_cast<int>(PIECE::B))
+                targets = bishop_attacks(from_square, occupancy);
+            else if(piece == static_cast<int>(PIECE::R))
+                targets = rook_attacks(from_square, occupancy);
+            else
+                targets = bishop_attacks(from_square, occupancy) | rook_attacks(from_square, occupancy);
+
+            targets &= targets_mask;
+            if(pinned & (1ULL << from_square))
+                targets &= line_through_squares[king_square][from_square];
+
+            add_piece_moves(legal_moves, from_square, targets, piece + piece_offset, their_occupancy);
+
+            pop_bit(piece_bitboard);
         }
-        // OCCUPANCIES
-        // remove target square
-        board.color_occupancy_bitboards[!board.color_to_move] &= ~( 1ULL << move.get_to_square() );
-
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::Q) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
-    }
-
-    //* MoveType::king_castle
-    if(move.get_move_type() == static_cast<int>(MoveType::king_castle)){
-        // king
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::K) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
-
-        // rook
-        const int rook_target_square = (move.get_from_square() + move.get_to_square())/2;
-        const int rook_from_square = board.color_to_move ? static_cast<int>(SQUARE::h8) : static_cast<int>(SQUARE::h1);
-        // const int rook_from_color = board.color_to_move ? static_cast<int>(SQUARE::h8) : static_cast<int>(SQUARE::h1);
-        // remove rook
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] &= ~(1ULL << rook_from_square);
-        //set rook
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] |= 1ULL << rook_target_square;
-
-        // UPDATE OCCUPANCIES [COLOR] | FOR ROOK
-        // remove rook
-        board.color_occupancy_bitboards[board.color_to_move] &= ~( 1ULL << rook_from_square); 
-        //set rook
-        board.color_occupancy_bitboards[board.color_to_move] |= 1ULL << rook_target_square;
-
-        // castle rights updated at the start of function
-    }
-
-    //* MoveType::queen_castle
-    if(move.get_move_type() == static_cast<int>(MoveType::queen_castle)){
-        // king
-        // remove from square
-        board.bitboards[move.get_piece()] &= ~( 1ULL << move.get_from_square() );
-        // set target square
-        board.bitboards[static_cast<int>(PIECE::K) + (board.color_to_move*6)] |= 1ULL << move.get_to_square();
-
-        // rook
-        const int rook_target_square = (move.get_from_square() + move.get_to_square())/2;
-        const int rook_from_square = board.color_to_move ? static_cast<int>(SQUARE::a8) : static_cast<int>(SQUARE::a1);
-        // remove rook
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] &= ~(1ULL << rook_from_square);
-        //set rook
-        board.bitboards[static_cast<int>(PIECE::R) + (board.color_to_move*6)] |= 1ULL << rook_target_square;
-
-        // UPDATE OCCUPANCIES [COLOR] | FOR ROOK
-        // remove rook
-        board.color_occupancy_bitboards[board.color_to_move] &= ~( 1ULL << rook_from_square); 
-        //set rook
-        board.color_occupancy_bitboards[board.color_to_move] |= 1ULL << rook_target_square;
-
-        // castle rights updated at the start of function
     }
 
+    //* PAWNS
+    const int push_offset = us == static_cast<int>(COLOR::white) ? 8 : -8;
+    const U64 promotion_rank = us == static_cast<int>(COLOR::white) ? RANK_8_MASK : RANK_1_MASK;
+    const U64 double_push_rank = us == static_cast<int>(COLOR::white) ? RANK_4_MASK : RANK_5_MASK;
+    const int pawn_piece = static_cast<int>(PIECE::P) + piece_offset;
+
+    U64 pawns = our_bitboards[static_cast<int>(PIECE::P)];
+    while(pawns){
+        int from_square = get_LS1B(pawns);
+
+        U64 allowed = check_mask;
+        if(pinned & (1ULL << from_square))
+            allowed &= line_through_squares[king_square][from_square];
+
+        // captures
+        U64 captures = pawn_lookup_attacks[us][from_square] & their_occupancy & allowed;
+        while(captures){
+            int to_square = get_LS1B(captures);
+            if((1ULL << to_square) & promotion_rank){
+                add_promotions(legal_moves, from_square, to_square, pawn_piece, true);
+            }
+            else{
+                Move move;
+                move.encode_move(from_square, to_square, pawn_piece, MoveType::capture);
+                legal_moves.push_back(move);
+            }
+            pop_bit(captures);
+        }
+
+        // pushes
+        int to_square = from_square + push_offset;
+        if(!(occupancy & (1ULL << to_square))){
+            if(allowed & (1ULL << to_square)){
+                if((1ULL << to_square) & promotion_rank){
+                    add_promotions(legal_moves, from_square, to_square, pawn_piece, false);
+                }
+                else{
+                    Move move;
+                    move.encode_move(from_square, to_square, pawn_piece, MoveType::quiet_move);
+                    legal_moves.push_back(move);
+                }
+            }
 
-    // update game state
-    board.halfmove_counter += 1;
-    board.fullmove_number = board.halfmove_counter/2;
+            int double_push_square = to_square + push_offset;
+            U64 double_push_bitboard = (1ULL << double_push_square) & double_push_rank;
+            if(double_push_bitboard && !(occupancy & double_push_bitboard) && (allowed & double_push_bitboard)){
+                Move move;
+                move.encode_move(from_square, double_push_square, pawn_piece, MoveType::double_pawn_push);
+                legal_moves.push_back(move);
+            }
+        }
 
-    // UPDATE OCCUPANCIES [COLOR]
-    // remove from square
-    board.color_occupancy_bitboards[board.color_to_move] &= ~( 1ULL << move.get_from_square() );
-    // add target square
-    board.color_occupancy_bitboards[board.color_to_move] |= 1ULL << move.get_to_square();
-    board.both_occupancy_bitboard = board.color_occupancy_bitboards[0] | board.color_occupancy_bitboards[1];
+        // en passant
+        // rare - legality checked by removing both pawns and looking for slider attacks on king
+        // (covers pins and discovered check along the rank)
+        if(game_state.en_passant_square != -1 && (pawn_lookup_attacks[us][from_square] & (1ULL << game_state.en_passant_square))){
+            const int ep_square = game_state.en_passant_square;
+            const int captured_square = ep_square - push_offset;
 
-    // update color to move game state
-    board.color_to_move = !board.color_to_move;
+            if(((1ULL << ep_square) | (1ULL << captured_square)) & check_mask){
+                U64 occupancy_after = (occupancy ^ (1ULL << from_square) ^ (1ULL << captured_square)) | (1ULL << ep_square);
 
-    // // check wheter king is in check
-    // int king_square = get_LS1B(board.bitboards[static_cast<int>(PIECE::K) + (!board.color_to_move * 6)]);
-    // bool isLegal = !is_square_attacked_by(king_square, board.color_to_move, board);
+                bool exposes_king =
+                    (bishop_attacks(king_square, occupancy_after) & their_diagonal_sliders) ||
+                    (rook_attacks(king_square, occupancy_after) & their_orthogonal_sliders);
 
+                if(!exposes_king){
+                    Move move;
+                    move.encode_move(from_square, ep_square, pawn_piece, MoveType::en_passant_capture);
+                    legal_moves.push_back(move);
+                }
+            }
+        }
 
-    // // return 1 if legal; 0 if not legal
-    // return isLegal;
-}
+        pop_bit(pawns);
+    }
 
-bool isMoveLegal(Move &move, Board &current_board){
-    Board board_copy = current_board;
+    //* CASTLING
+    // not in check, squares between king and rook empty, king doesn't pass attacked square
+    if(!checkers){
+        if(us == static_cast<int>(COLOR::white)){
+            if((game_state.castles & 0b0100) && !(occupancy & white_kingside_empty_squares_castling_mask) &&
+               !(danger & ((1ULL << static_cast<int>(SQUARE::f1)) | (1ULL << static_cast<int>(SQUARE::g1))))){
+                Move move;
+                move.encode_move(king_square, static_cast<int>(SQUARE::g1), static_cast<int>(PIECE::K), MoveType::king_castle);
+                legal_moves.push_back(move);
+            }
+            if((game_state.castles & 0b1000) && !(occupancy & white_queenside_empty_squares_castling_mask) &&
+               !(danger & ((1ULL << static_cast<int>(SQUARE::d1)) | (1ULL << static_cast<int>(SQUARE::c1))))){
+                Move move;
+                move.encode_move(king_square, static_cast<int>(SQUARE::c1), static_cast<int>(PIECE::K), MoveType::queen_castle);
+                legal_moves.push_back(move);
+            }
+        }
+        else{
+            if((game_state.castles & 0b0001) && !(occupancy & black_kingside_empty_squares_castling_mask) &&
+               !(danger & ((1ULL << static_cast<int>(SQUARE::f8)) | (1ULL << static_cast<int>(SQUARE::g8))))){
+                Move move;
+                move.encode_move(king_square, static_cast<int>(SQUARE::g8), static_cast<int>(PIECE::k), MoveType::king_castle);
+                legal_moves.push_back(move);
+            }
+            if((game_state.castles & 0b0010) && !(occupancy & black_queenside_empty_squares_castling_mask) &&
+               !(danger & ((1ULL << static_cast<int>(SQUARE::d8)) | (1ULL << static_cast<int>(SQUARE::c8))))){
+                Move move;
+                move.encode_move(king_square, static_cast<int>(SQUARE::c8), static_cast<int>(PIECE::k), MoveType::queen_castle);
+                legal_moves.push_back(move);
+            }
+        }
+    }
+}
 
-    // make move
-    make_move(move, board_copy);
+std::vector<Move> generate_legal_moves(Board &game_state){
+    MoveList legal_moves;
+    generate_legal_moves(game_state, legal_moves);
 
-    // check wheter king is in check
-    int king_square = get_LS1B(board_copy.bitboards[static_cast<int>(PIECE::K) + (!board_copy.color_to_move * 6)]);
-    bool isLegal = !is_square_attacked_by(king_square, board_copy.color_to_move, board_copy);
+    return std::vector<Move>(legal_moves.begin(), legal_moves.end());
+}
 
-    return isLegal;
+void compute_check_info(Board &board, CheckInfo &check_info){
+    const int us = board.color_to_move;
+    const int them = !us;
+    const U64 occupancy = board.both_occupancy_bitboard;
+    const U64 *our_bitboards = board.bitboards + us * 6;
+
+    const int king_square = get_LS1B(board.bitboards[static_cast<int>(PIECE::K) + them * 6]);
+    check_info.king_square = king_square;
+
+    const U64 diagonal = bishop_attacks(king_square, occupancy);
+    const U64 orthogonal = rook_attacks(king_square, occupancy);
+
+    // our pawn on square attacks king <=> enemy pawn on king square attacks that square
+    check_info.check_squares[static_cast<int>(PIECE::P)] = pawn_lookup_attacks[them][king_square];
+    check_info.check_squares[static_cast<int>(PIECE::R)] = orthogonal;
+    check_info.check_squares[static_cast<int>(PIECE::N)] = knight_lookup_attacks[king_square];
+    check_info.check_squares[static_cast<int>(PIECE::B)] = diagonal;
+    check_info.check_squares[static_cast<int>(PIECE::Q)] = diagonal | orthogonal;
+    check_info.check_squares[static_cast<int>(PIECE::K)] = 0ULL;
+
+    // our sliders aimed at king (empty board), exactly one of our pieces in between
+    U64 snipers = (rook_attacks(king_square, 0ULL) & (our_bitboards[static_cast<int>(PIECE::R)] | our_bitboards[static_cast<int>(PIECE::Q)])) |
+                  (bishop_attacks(king_square, 0ULL) & (our_bitboards[static_cast<int>(PIECE::B)] | our_bitboards[static_cast<int>(PIECE::Q)]));
+
+    check_info.discovered_check_candidates = 0ULL;
+    while(snipers){
+        U64 blockers = between_squares[king_square][get_LS1B(snipers)] & occupancy;
+        if(blockers && !(blockers & (blockers - 1)))
+            check_info.discovered_check_candidates |= blockers & board.color_occupancy_bitboards[us];
+        pop_bit(snipers);
+    }
 }
 
-std::vector<Move> generate_legal_moves(Board &game_state){
-    std::vector<Move> pseudo_legal_moves = generate_moves(game_state);
-    std::vector<Move> legal_moves;
-    legal_moves.reserve(pseudo_legal_moves.size());
-
-    for(Move &move : pseudo_legal_moves){
-        bool isLegal = isMoveLegal(move, game_state);
-        // printf("bool : %d\n", isLegal);
-        if(isLegal){
-            legal_moves.push_back(move);
-        }
+bool gives_check(const Move &move, Board &board, const CheckInfo &check_info){
+    const int from_square = move.get_from_square();
+    const int to_square = move.get_to_square();
+    const int move_type = move.get_move_type();
+
+    // rare - rook check after castle, discovered check through captured pawn square
+    if(move_type == static_cast<int>(MoveType::en_passant_capture) ||
+       move_type == static_cast<int>(MoveType::king_castle) || move_type == static_cast<int>(MoveType::queen_castle)){
+        Undo undo;
+        make_move(move, board, undo);
+        bool check = isKingUnderAttack(board);
+        unmake_move(move, undo, board);
+        return check;
     }
 
-    return legal_moves;
+    // discovered check - blocker leaves line to king
+    if((check_info.discovered_check_candidates & (1ULL << from_square)) &&
+       !(line_through_squares[check_info.king_square][from_square] & (1ULL << to_square)))
+        return true;
+
+    // direct check
+    if(!(move_type & static_cast<int>(MoveType::knight_promotion)))
+        return check_info.check_squares[move.get_piece() % 6] & (1ULL << to_square);
+
+    // promoted piece attacks king (pawn left from square)
+    const U64 occupancy = board.both_occupancy_bitboard ^ (1ULL << from_square);
+    const U64 king_bitboard = 1ULL << check_info.king_square;
+    switch(move_type & 0b11){
+        case 0: return knight_lookup_attacks[to_square] & king_bitboard;
+        case 1: return bishop_attacks(to_square, occupancy) & king_bitboard;
+        case 2: return rook_attacks(to_square, occupancy) & king_bitboard;
+        default: return (bishop_attacks(to_square, occupancy) | rook_attacks(to_square, occupancy)) & king_bitboard;
+    }
 }
 
 bool isKingUnderAttack(Board &board, bool other_side){
@@ -711,7 +1072,13 @@ bool isKingUnderAttack(Board &board, bool other_side){
 }
 
 bool isCheckMate(Board &board){
-    if(isKingUnderAttack(board) && generate_legal_moves(board).size() == 0){
+    if(!isKingUnderAttack(board)){
+        return false;
+    }
+
+    MoveList legal_moves;
+    generate_legal_moves(board, legal_moves);
+    if(legal_moves.size() == 0){
         return true;
     }
 
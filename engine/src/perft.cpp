@@ -1,19 +1,125 @@
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+
 #include "perft.hpp"
 
+// debug build (ENGINE_VERIFY_HASH): incremental zobrist keys and psqt score must match values computed from scratch
+inline void verify_hash_keys([[maybe_unused]] const Board &board){
+#ifdef ENGINE_VERIFY_HASH
+    if(board.hash_key != board.compute_hash_key() ||
+       board.pawn_key != board.compute_pawn_key() ||
+       board.material_key != board.compute_material_key()){
+        throw std::runtime_error("Incremental zobrist key mismatch");
+    }
+    if(board.psqt_score != board.compute_psqt_score())
+        throw std::runtime_error("Incremental psqt score mismatch");
+#endif
+}
+
 void printPerftObject(PerftMovesCount obj){
     printf("count: %llu, captures: %llu, ep: %llu, castles: %llu, promotion: %llu, checks: %llu, checkmates: %llu\n",
             obj.count, obj.captures, obj.en_pasants, obj.castles, obj.promotion, obj.checks, obj.checkmates);
 }
 
-PerftMovesCount perf(int depth, Board &board){
+// ************************************
+// *        PERFT HASH TABLE
+// ************************************
+
+PerftTable::PerftTable(size_t size_mb){
+    resize(size_mb);
+}
+
+void PerftTable::resize(size_t size_mb){
+    // largest power of two number of entries that fits in size_mb
+    size_t bytes = size_mb * 1024 * 1024;
+    size_t entries_count = 1;
+    while(entries_count * 2 * sizeof(PerftTableEntry) <= bytes)
+        entries_count *= 2;
+
+    entries = std::vector<PerftTableEntry>(entries_count);
+    index_mask = entries_count - 1;
+}
+
+void PerftTable::clear(){
+    for(PerftTableEntry &entry : entries)
+        for(std::atomic<U64> &word : entry.words)
+            word.store(0, std::memory_order_relaxed);
+}
+
+// depth is mixed into index so one position at different depths doesn't fight for single slot
+inline size_t PerftTable::index(U64 key, int depth) const{
+    return (key ^ (depth * 0x9E3779B97F4A7C15ULL)) & index_mask;
+}
+
+// check word = key ^ depth ^ all data words
+// torn entry (written by other thread in the meantime) fails the check and is treated as miss
+bool PerftTable::probe(U64 key, int depth, PerftMovesCount &counts) const{
+    const PerftTableEntry &entry = entries[index(key, depth)];
+
+    U64 words[PERFT_ENTRY_WORDS];
+    U64 check = key ^ depth;
+    for(int i = 0; i < PERFT_ENTRY_WORDS; i++){
+        words[i] = entry.words[i].load(std::memory_order_relaxed);
+        check ^= words[i];
+    }
+
+    // all words XORed with check word give 0 on valid entry
+    if(check != 0 || words[1] != (U64)depth)
+        return false;
+
+    counts.count = words[2];
+    counts.captures = words[3];
+    counts.en_pasants = words[4];
+    counts.checks = words[5];
+    counts.checkmates = words[6];
+    counts.castles = words[7];
+    counts.promotion = words[8];
+
+    return true;
+}
+
+void PerftTable::store(U64 key, int depth, const PerftMovesCount &counts){
+    PerftTableEntry &entry = entries[index(key, depth)];
+
+    U64 words[PERFT_ENTRY_WORDS] = {
+        0, (U64)depth, counts.count, counts.captures, counts.en_pasants,
+        counts.checks, counts.checkmates, counts.castles, counts.promotion
+    };
+    words[0] = key ^ depth;
+    for(int i = 1; i < PERFT_ENTRY_WORDS; i++)
+        words[0] ^= words[i];
+
+    // always replace
+    for(int i = 0; i < PERFT_ENTRY_WORDS; i++)
+        entry.words[i].store(words[i], std::memory_order_relaxed);
+}
+
+// ************************************
+// *             PERFT
+// ************************************
+
+PerftMovesCount perf(int depth, Board &board, PerftTable *table){
     PerftMovesCount moves_count;
 
+    verify_hash_keys(board);
+
     if(depth == 0){
         return moves_count;
     }
 
+    const bool use_table = table && depth >= PERFT_HASH_MIN_DEPTH;
+
+    if(use_table && table->probe(board.hash_key, depth, moves_count)){
+        return moves_count;
+    }
+
+    MoveList moves;
+    generate_legal_moves(board, moves);
+
     if(depth == 1){
-        auto moves = generate_legal_moves(board);
+        CheckInfo check_info;
+        compute_check_info(board, check_info);
 
         for(const Move &move : moves){
             if (move.get_move_type() & static_cast<int>(MoveType::capture)){
@@ -31,38 +137,179 @@ PerftMovesCount perf(int depth, Board &board){
             if (move.get_move_type() & static_cast<int>(MoveType::knight_promotion)){
                 moves_count.promotion += 1;
             }
-            
-            Board copy = board;
-            make_move(move, copy);
-            if( isKingUnderAttack(copy) ){
+
+            // checks from check squares / discovered check candidates
+            // only checking moves are made (mate = check without legal reply)
+            if(gives_check(move, board, check_info)){
                 moves_count.checks += 1;
-            }
 
-            if(isCheckMate(copy)){
-                moves_count.checkmates += 1;
+                Undo undo;
+                make_move(move, board, undo);
+                verify_hash_keys(board);
+                MoveList replies;
+                generate_legal_moves(board, replies);
+                if(replies.size() == 0){
+                    moves_count.checkmates += 1;
+                }
+                unmake_move(move, undo, board);
             }
         }
 
         moves_count.count = moves.size();
+    }
+    else{
+        for(const Move &move : moves){
+            Undo undo;
+            make_move(move, board, undo);
+            moves_count += perf(depth-1, board, table);
+            unmake_move(move, undo, board);
+        }
+    }
 
-        return moves_count;
+    if(use_table){
+        table->store(board.hash_key, depth, moves_count);
     }
-    
-    auto moves = generate_legal_moves(board);
+
+    return moves_count;
+}
+
+unsigned long long perft_count(int depth, Board &board, PerftTable *table){
+    if(depth == 0){
+        return 1;
+    }
+
+    MoveList moves;
+    generate_legal_moves(board, moves);
+
+    // bulk counting - leaf moves are not made
+    if(depth == 1){
+        return moves.size();
+    }
+
+    PerftMovesCount cached;
+    if(table && table->probe(board.hash_key, depth + PERFT_COUNT_ONLY_DEPTH, cached)){
+        return cached.count;
+    }
+
+    unsigned long long nodes = 0;
+    for(const Move &move : moves){
+        Undo undo;
+        make_move(move, board, undo);
+        nodes += perft_count(depth - 1, board, table);
+        unmake_move(move, undo, board);
+    }
+
+    if(table){
+        cached.count = nodes;
+        table->store(board.hash_key, depth + PERFT_COUNT_ONLY_DEPTH, cached);
+    }
+
+    return nodes;
+}
+
+// ************************************
+// *        PARALLEL PERFT
+// ************************************
+
+// work item: moves from root to position at split ply
+struct PerftWorkItem{
+    Move moves[MAX_PERFT_SPLIT_PLY];
+};
+
+// collect every position at split_ply (as move path from root)
+// split_ply <= MAX_PERFT_SPLIT_PLY (clamped by caller); explicit bound keeps path.moves index provably in range
+void collect_work_items(int ply, int split_ply, Board &board, PerftWorkItem &path, std::vector<PerftWorkItem> &items){
+    if(ply == split_ply || ply >= MAX_PERFT_SPLIT_PLY){
+        items.push_back(path);
+        return;
+    }
+
+    MoveList moves;
+    generate_legal_moves(board, moves);
 
     for(const Move &move : moves){
-        Board copy = board;
-        make_move(move, copy);
-
-        PerftMovesCount new_count = perf(depth-1, copy);
-        moves_count.count += new_count.count;
-        moves_count.captures += new_count.captures;
-        moves_count.en_pasants += new_count.en_pasants;
-        moves_count.checks += new_count.checks;
-        moves_count.checkmates += new_count.checkmates;
-        moves_count.castles += new_count.castles;
-        moves_count.promotion += new_count.promotion;
+        path.moves[ply] = move;
+        Undo undo;
+        make_move(move, board, undo);
+        collect_work_items(ply + 1, split_ply, board, path, items);
+        unmake_move(move, undo, board);
     }
+}
+
+// contiguous range of work items owned by one thread
+// owner and thieves take items from the front with fetch_add
+struct alignas(64) PerftWorkRange{
+    std::atomic<size_t> next{0};
+    size_t end = 0;
+};
+
+// per thread accumulator, padded to own cache line
+struct alignas(64) PerftThreadResult{
+    PerftMovesCount counts;
+};
+
+PerftMovesCount parallel_perf(int depth, Board &board, int threads_count, int split_ply, PerftTable *table, PerftMode mode){
+    // positions at split ply must still have subtree below them
+    // (depth <= 0: no split, upper bound below 0 must not reach std::clamp)
+    split_ply = std::max(0, std::min({split_ply, depth - 1, MAX_PERFT_SPLIT_PLY}));
+    if(threads_count <= 1 || split_ply <= 0){
+        if(mode == PerftMode::count_only){
+            PerftMovesCount moves_count;
+            moves_count.count = perft_count(depth, board, table);
+            return moves_count;
+        }
+        return perf(depth, board, table);
+    }
+
+    std::vector<PerftWorkItem> items;
+    PerftWorkItem path;
+    collect_work_items(0, split_ply, board, path, items);
+
+    std::vector<PerftWorkRange> ranges(threads_count);
+    for(int i = 0; i < threads_count; i++){
+        ranges[i].next = items.size() * i / threads_count;
+        ranges[i].end = items.size() * (i + 1) / threads_count;
+    }
+
+    std::vector<PerftThreadResult> results(threads_count);
+
+    auto worker = [&](int thread_index){
+        Board thread_board = board;
+        PerftMovesCount &counts = results[thread_index].counts;
+
+        // own range first, then steal from others
+        for(int offset = 0; offset < threads_count; offset++){
+            PerftWorkRange &range = ranges[(thread_index + offset) % threads_count];
+
+            size_t item_index;
+            while((item_index = range.next.fetch_add(1, std::memory_order_relaxed)) < range.end){
+                const PerftWorkItem &item = items[item_index];
+
+                Undo undos[MAX_PERFT_SPLIT_PLY];
+                for(int ply = 0; ply < split_ply; ply++)
+                    make_move(item.moves[ply], thread_board, undos[ply]);
+
+                if(mode == PerftMode::count_only)
+                    counts.count += perft_count(depth - split_ply, thread_board, table);
+                else
+                    counts += perf(depth - split_ply, thread_board, table);
+
+                for(int ply = split_ply - 1; ply >= 0; ply--)
+                    unmake_move(item.moves[ply], undos[ply], thread_board);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(int i = 1; i < threads_count; i++)
+        threads.emplace_back(worker, i);
+    worker(0);
+    for(std::thread &thread : threads)
+        thread.join();
+
+    PerftMovesCount moves_count;
+    for(const PerftThreadResult &result : results)
+        moves_count += result.counts;
 
     return moves_count;
 }
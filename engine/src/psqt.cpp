@@ -0,0 +1,33 @@
+#include "psqt.hpp"
+#include "enums.hpp"
+#include "pieces_weights.hpp"
+
+// same terms as from-scratch eval (king: material only)
+constexpr int piece_square_bonus(int piece, int square){
+    switch(piece){
+        case static_cast<int>(PIECE::P): return PAWN_WHITE_PSQT[square];
+        case static_cast<int>(PIECE::p): return PAWN_BLACK_PSQT[square];
+    }
+
+    switch(piece % 6){
+        case static_cast<int>(PIECE::R): return ROOK_PSQT[square];
+        case static_cast<int>(PIECE::N): return KNIGHT_PSQT[square];
+        case static_cast<int>(PIECE::B): return BISHOP_PSQT[square];
+        case static_cast<int>(PIECE::Q): return QUEEN_PSQT[square];
+        default: return 0;
+    }
+}
+
+constexpr std::array<std::array<int, 64>, 12> generate_piece_square_scores(){
+    std::array<std::array<int, 64>, 12> scores{};
+
+    for(int piece = 0; piece < 12; piece++){
+        const int color_factor = piece < 6 ? 1 : -1;
+        for(int square = 0; square < 64; square++)
+            scores[piece][square] = color_factor * (PIECE_VALUE[piece % 6] + piece_square_bonus(piece, square));
+    }
+
+    return scores;
+}
+
+constinit const std::array<std::array<int, 64>, 12> piece_square_scores = generate_piece_square_scores();
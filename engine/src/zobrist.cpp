@@ -0,0 +1,39 @@
+#include "zobrist.hpp"
+
+constexpr U64 ZOBRIST_SEED = 0x9E3779B97F4A7C15ULL;
+
+// all keys drawn from one stream, in fixed order: pieces, castles, en passant, side
+struct ZobristKeys{
+    std::array<std::array<U64, 64>, 12> pieces{};
+    std::array<U64, 16> castles{};
+    std::array<U64, 8> en_passant{};
+    U64 side = 0ULL;
+};
+
+constexpr ZobristKeys generate_zobrist_keys(){
+    ZobristKeys keys;
+    U64 state = ZOBRIST_SEED;
+
+    for(auto &piece_keys : keys.pieces)
+        for(U64 &key : piece_keys)
+            key = zobrist_random(state);
+
+    // no castle rights -> key 0
+    keys.castles[0] = 0ULL;
+    for(int i = 1; i < 16; i++)
+        keys.castles[i] = zobrist_random(state);
+
+    for(U64 &key : keys.en_passant)
+        key = zobrist_random(state);
+
+    keys.side = zobrist_random(state);
+
+    return keys;
+}
+
+constexpr ZobristKeys zobrist_keys = generate_zobrist_keys();
+
+constinit const std::array<std::array<U64, 64>, 12> zobrist_piece_keys = zobrist_keys.pieces;
+constinit const std::array<U64, 16> zobrist_castle_keys = zobrist_keys.castles;
+constinit const std::array<U64, 8> zobrist_en_passant_keys = zobrist_keys.en_passant;
+constinit const U64 zobrist_side_key = zobrist_keys.side;
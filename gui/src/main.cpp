@@ -4,12 +4,15 @@
 #include <iostream>
 #include <map>
 #include <array>
+#include <algorithm>
+#include <thread>
 
 #include "board.hpp"
 #include "attacks.hpp"
 #include "utility.hpp"
 #include "moves.hpp"
 #include <chess_bot.hpp>
+#include <search.hpp>
 #include <visualisation.hpp>
 
 std::map<char, sf::Texture> loadPieceTextures(const std::string &img_dir_path) {
@@ -51,13 +54,18 @@ int main()
     const sf::Color activeSquareColor  = sf::Color(200, 40, 30);   // ciemny
     const sf::Color possibleSquareColor  = sf::Color(40, 200, 60);   // ciemny
 
+    // czas bota na ruch (ms)
+    constexpr int BOT_MOVE_TIME_MS = 1000;
+    // wątki bota - lazy smp (0 - wszystkie wątki sprzętowe)
+    constexpr int BOT_THREADS = 0;
+
     int active_square = -1;
 
     std::vector<int> possible_squares;
     std::vector<Move> possible_moves;
 
     Board board;
-    init_all_lookup_tables(board);
+    init_all_lookup_tables();
     board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
 
@@ -201,7 +209,10 @@ int main()
         window.display();
 
         if(board.color_to_move == 1){
-            Move best_move = get_best_move(board, 4);
+            SearchLimits limits;
+            limits.movetime = BOT_MOVE_TIME_MS;
+            limits.threads = BOT_THREADS > 0 ? BOT_THREADS : std::max(1, (int)std::thread::hardware_concurrency());
+            Move best_move = search_best_move(board, limits).best_move;
             // best_move.print();
             make_move(best_move, board);
             board_position = board.board_to_char_array();